@@ -42,12 +42,20 @@ CAvability::CAvability()
 {
     available = false;
     name = 0;
+    path = 0;
+    fallbacks = 0;
+    archive = 0;
+    archiveIndex = -1;
 }
 
 CAvability::~CAvability()
 {
     if (name!=0)
         delete name;
+    if (path!=0)
+        delete path;
+    if (fallbacks!=0)
+        delete fallbacks;
 }
 
 void CAvability::setAvailable(const QString &n)
@@ -58,3 +66,32 @@ void CAvability::setAvailable(const QString &n)
 
     available = true;
 }
+
+void CAvability::setPath(const QString &p)
+{
+    if (path==0)
+        path = new QString(p); else
+        (*path) = p;
+}
+
+void CAvability::addFallback(const QString &filename)
+{
+    if (fallbacks==0)
+        fallbacks = new QStringList();
+
+    fallbacks->append(filename);
+}
+
+void CAvability::setArchive(CHgtArchive *a, int index)
+{
+    archive = a;
+    archiveIndex = index;
+}
+
+QString CAvability::getFilePath(const QString &defaultPath)
+{
+    if (path!=0)
+        return (*path) + (*name);
+
+    return defaultPath + (*name);
+}
@@ -39,16 +39,27 @@
 #define CAVABILITY_H
 
 #include <QString>
+#include <QStringList>
+
+class CHgtArchive;
 
 class CAvability
 {
 public:
     bool available;
     QString *name;
+    QString *path;              // directory of file, 0 = default directory of level
+    QStringList *fallbacks;     // lower priority files filling voids, 0 = none
+    CHgtArchive *archive;       // archive holding tile, 0 = loose file
+    int archiveIndex;
 
     CAvability();
     ~CAvability();
     void setAvailable(const QString &n);
+    void setPath(const QString &p);
+    void addFallback(const QString &filename);
+    void setArchive(CHgtArchive *a, int index);
+    QString getFilePath(const QString &defaultPath);
 };
 
 #endif // CAVABILITY_H
@@ -35,14 +35,18 @@
  *   -------------------------------------------------------------------------
  */
 
-#include <QTime>
 #include <math.h>
 #include <QDebug>
 #include <QDir>
 #include <QFileInfoList>
 #include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
 #include "CCacheManager.h"
 #include "CHgtFile.h"
+#include "CScopedTimer.h"
+#include "CHgtArchive.h"
+#include "CLog.h"
 
 CCacheManager *CCacheManager::instance;
 
@@ -53,15 +57,7 @@ CCacheManager::CCacheManager()
     // something like singleton :)
     instance = this;
 
-    pathBase = ""; // "E:\\HgtReader_data\\";
-    pathL00_L03 = pathBase + "L00-L03\\";
-    pathL04_L08 = pathBase + "L04-L08\\";
-    pathL09_L13 = pathBase + "L09-L13\\";
-    pathSRTM = pathBase + "NASA_SRTM\\";
-    pathL00_L03_index = pathBase + "L00-L03_index\\";
-    pathL04_L08_index = pathBase + "L04-L08_index\\";
-    pathL09_L13_index = pathBase + "L09-L13_index\\";
-    pathSRTM_index = pathBase + "NASA_SRTM_index\\";
+    setupPaths("", ""); // "E:\\HgtReader_data\\";
 
     // generate degree size of tile in each LOD
     LODdegreeSizeLookUp[0] = 60.0;
@@ -88,6 +84,14 @@ CCacheManager::CCacheManager()
     for (i=4; i<=8; i++)  HGTsourceSkippingLookUp[i] = pow(2, 8-i);
     for (i=9; i<=13; i++) HGTsourceSkippingLookUp[i] = pow(2, 13-i);
 
+    avability_L00_L03 = 0;
+    avability_L04_L08 = 0;
+    avability_L09_L13 = 0;
+    avability_SRTM = 0;
+    archive_L00_L03 = new CHgtArchive();
+    archive_L04_L08 = new CHgtArchive();
+    archive_L09_L13 = new CHgtArchive();
+
     // setup avability tables by reading each HGT files directory
     setupAvabilityTables();
 }
@@ -97,6 +101,22 @@ CCacheManager *CCacheManager::getInstance()
     return instance;
 }
 
+void CCacheManager::setupPaths(const QString &inputRoot, const QString &outputRoot)
+{
+    // SRTM data is only read, levels and indexes are written to output root
+    pathBase = addSeparator(outputRoot);
+    pathL00_L03 = pathBase + "L00-L03\\";
+    pathL04_L08 = pathBase + "L04-L08\\";
+    pathL09_L13 = pathBase + "L09-L13\\";
+    pathSRTM = addSeparator(inputRoot) + "NASA_SRTM\\";
+    pathSRTMconfig = addSeparator(inputRoot) + "SRTM_sources.txt";
+    pathL00_L03_index = pathBase + "L00-L03_index\\";
+    pathL04_L08_index = pathBase + "L04-L08_index\\";
+    pathL09_L13_index = pathBase + "L09-L13_index\\";
+    pathSRTM_index = pathBase + "NASA_SRTM_index\\";
+    pathXYZ = pathBase + "XYZ\\";
+}
+
 void CCacheManager::setupAvabilityTables()
 {
     int i, index;
@@ -104,6 +124,9 @@ void CCacheManager::setupAvabilityTables()
     QDir dir;
     QFileInfo fileInfo;
     QFileInfoList list;
+    QStringList fields;
+    int root;
+    CScopedTimer timer("scan");
     int L00_L03_width  = (int)(360.0 / HGT_SOURCE_DEGREE_SIZE_L00_L03);
     int L00_L03_height = (int)(180.0 / HGT_SOURCE_DEGREE_SIZE_L00_L03);
     int L04_L08_width  = (int)(360.0 / HGT_SOURCE_DEGREE_SIZE_L04_L08);
@@ -113,6 +136,12 @@ void CCacheManager::setupAvabilityTables()
     int SRTM_width     = (int)(360.0 / HGT_SOURCE_DEGREE_SIZE_SRTM);
     int SRTM_height    = (int)(180.0 / HGT_SOURCE_DEGREE_SIZE_SRTM);
 
+    // tables can be set up again after tiles were added
+    if (avability_L00_L03!=0) delete []avability_L00_L03;
+    if (avability_L04_L08!=0) delete []avability_L04_L08;
+    if (avability_L09_L13!=0) delete []avability_L09_L13;
+    if (avability_SRTM!=0)    delete []avability_SRTM;
+
     avability_L00_L03 = new CAvability[L00_L03_width * L00_L03_height];
     avability_L04_L08 = new CAvability[L04_L08_width * L04_L08_height];
     avability_L09_L13 = new CAvability[L09_L13_width * L09_L13_height];
@@ -126,7 +155,7 @@ void CCacheManager::setupAvabilityTables()
 
     for (i=0; i<list.size(); i++) {
         fileInfo = list.at(i);
-        if (fileInfo.size()==8450 && fileInfo.suffix()=="hgt") {
+        if (fileInfo.suffix()=="hgt" && CHgtFile::checkFile(fileInfo.absoluteFilePath(), fileInfo.size(), HGT_SOURCE_SIZE_L00_L03, HGT_SOURCE_SIZE_L00_L03)) {
             convertFileNameToLonLat(fileInfo.fileName(), &tlLon, &tlLat);
             convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_L00_L03, &index);
             avability_L00_L03[index].setAvailable(fileInfo.fileName());
@@ -141,7 +170,7 @@ void CCacheManager::setupAvabilityTables()
 
     for (i=0; i<list.size(); i++) {
         fileInfo = list.at(i);
-        if (fileInfo.size()==526338 && fileInfo.suffix()=="hgt") {
+        if (fileInfo.suffix()=="hgt" && CHgtFile::checkFile(fileInfo.absoluteFilePath(), fileInfo.size(), HGT_SOURCE_SIZE_L04_L08, HGT_SOURCE_SIZE_L04_L08)) {
             convertFileNameToLonLat(fileInfo.fileName(), &tlLon, &tlLat);
             convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_L04_L08, &index);
             avability_L04_L08[index].setAvailable(fileInfo.fileName());
@@ -156,26 +185,143 @@ void CCacheManager::setupAvabilityTables()
 
     for (i=0; i<list.size(); i++) {
         fileInfo = list.at(i);
-        if (fileInfo.size()==33570818 && fileInfo.suffix()=="hgt") {
+        if (fileInfo.suffix()=="hgt" && CHgtFile::checkFile(fileInfo.absoluteFilePath(), fileInfo.size(), HGT_SOURCE_SIZE_L09_L13, HGT_SOURCE_SIZE_L09_L13)) {
             convertFileNameToLonLat(fileInfo.fileName(), &tlLon, &tlLat);
             convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_L09_L13, &index);
             avability_L09_L13[index].setAvailable(fileInfo.fileName());
         }
     }
 
-    // SRTM files
-    dir.setPath(pathSRTM);
-    dir.setFilter(QDir::Files | QDir::NoSymLinks);
-    dir.setSorting(QDir::Name);
-    list = dir.entryInfoList();
+    // archives - loose files have priority, so tiles can be replaced without repacking
+    setupArchive(HGT_SOURCE_L00_L03);
+    setupArchive(HGT_SOURCE_L04_L08);
+    setupArchive(HGT_SOURCE_L09_L13);
+
+    // SRTM files - all roots, first one having tile is used, others fill voids
+    setupSRTMroots();
+    for (root=0; root<pathSRTMroots.size(); root++) {
+        dir.setPath(pathSRTMroots.at(root));
+        dir.setFilter(QDir::Files | QDir::NoSymLinks);
+        dir.setSorting(QDir::Name);
+        list = dir.entryInfoList();
+
+        for (i=0; i<list.size(); i++) {
+            fileInfo = list.at(i);
+            if (fileInfo.size()==2884802 && fileInfo.suffix()=="hgt") {
+                convertSRTMfileNameToLonLat(fileInfo.fileName(), &tlLon, &tlLat);
+                convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_SRTM, &index);
+                if ( ! avability_SRTM[index].available) {
+                    avability_SRTM[index].setAvailable(fileInfo.fileName());
+                    avability_SRTM[index].setPath(pathSRTMroots.at(root));
+                } else {
+                    avability_SRTM[index].addFallback(pathSRTMroots.at(root) + fileInfo.fileName());
+                }
+            }
+        }
+    }
 
-    for (i=0; i<list.size(); i++) {
-        fileInfo = list.at(i);
-        if (fileInfo.size()==2884802 && fileInfo.suffix()=="hgt") {
-            convertSRTMfileNameToLonLat(fileInfo.fileName(), &tlLon, &tlLat);
-            convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_SRTM, &index);
-            avability_SRTM[index].setAvailable(fileInfo.fileName());
+    // per tile overrides - chosen root goes first, previous one becomes first fallback
+    for (i=0; i<SRTMoverrides.size(); i++) {
+        fields = SRTMoverrides.at(i).split(' ', QString::SkipEmptyParts);
+        root = fields.at(2).toInt();
+        if (root<0 || root>=pathSRTMroots.size()) continue;
+
+        convertSRTMfileNameToLonLat(fields.at(1), &tlLon, &tlLat);
+        convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_SRTM, &index);
+        if ( ! avability_SRTM[index].available || avability_SRTM[index].fallbacks==0) continue;
+        if ( ! avability_SRTM[index].fallbacks->contains(pathSRTMroots.at(root) + fields.at(1))) continue;
+
+        avability_SRTM[index].fallbacks->removeAll(pathSRTMroots.at(root) + fields.at(1));
+        avability_SRTM[index].fallbacks->prepend(avability_SRTM[index].getFilePath(pathSRTM));
+        avability_SRTM[index].setPath(pathSRTMroots.at(root));
+    }
+}
+
+QString CCacheManager::addSeparator(const QString &dir)
+{
+    // empty stays relative to working directory, separator style of dir is kept
+    if (dir.isEmpty() || dir.endsWith("/") || dir.endsWith("\\")) return dir;
+    if (dir.contains("/")) return dir + "/";
+
+    return dir + "\\";
+}
+
+void CCacheManager::setupArchive(int hgtSource)
+{
+    CHgtArchive *archive = getArchive(hgtSource);
+    CAvability *avab = getAvability(hgtSource);
+    double degreeSize = getSourceDegreeSize(hgtSource);
+    QString filename;
+    double tlLon, tlLat;
+    int i, tiles;
+
+    if ( ! archive->open(CHgtArchive::getFileName(hgtSource))) return;
+    // index is keyed by avability index, archive of other level or grid
+    // would put tiles on wrong places or past end of avab
+    if (archive->getHgtSource()!=hgtSource ||
+        archive->getCount()!=((int)(360.0 / degreeSize)) * ((int)(180.0 / degreeSize))) {
+        LOG_WARNING << "Archive" << CHgtArchive::getFileName(hgtSource) << "doesn't match level, ignored";
+        archive->close();
+        return;
+    }
+
+    tiles = 0;
+    for (i=0; i<archive->getCount(); i++) {
+        if ( ! archive->contains(i) || avab[i].available) continue;
+
+        convertAvabilityIndex2TopLeft(i, degreeSize, &tlLon, &tlLat);
+        convertLonLatToFileName(tlLon, tlLat, &filename);
+        avab[i].setAvailable(filename);
+        avab[i].setArchive(archive, i);
+        tiles++;
+    }
+    LOG_INFO << "Archive" << CHgtArchive::getFileName(hgtSource) << ":" << tiles << "tiles";
+}
+
+void CCacheManager::setupSRTMroots()
+{
+    QFile file(pathSRTMconfig);
+    QString line;
+    QStringList fields;
+
+    // config lines:  root <directory>              in priority order
+    //                override <SRTM file> <root>   root number counted from 0
+    pathSRTMroots.clear();
+    SRTMoverrides.clear();
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while ( ! in.atEnd()) {
+            line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith("#")) continue;
+
+            fields = line.split(' ', QString::SkipEmptyParts);
+            if (fields.at(0)=="root" && fields.size()==2)
+                pathSRTMroots.append(addSeparator(fields.at(1)));
+            if (fields.at(0)=="override" && fields.size()==3)
+                SRTMoverrides.append(line);
         }
+        file.close();
+    }
+
+    if (pathSRTMroots.isEmpty())
+        pathSRTMroots.append(pathSRTM);
+    LOG_INFO << "SRTM roots:" << pathSRTMroots.join(", ") << " overrides:" << SRTMoverrides.size();
+}
+
+void CCacheManager::loadSRTMFile(int index, CHgtFile *hgt)
+{
+    CAvability *avab = &avability_SRTM[index];
+    CHgtFile fallback;
+    int voids, i;
+
+    hgt->loadFile(avab->getFilePath(pathSRTM), HGT_SOURCE_SIZE_SRTM, HGT_SOURCE_SIZE_SRTM);
+    if (avab->fallbacks==0)
+        return;
+
+    voids = hgt->countVoids();
+    for (i=0; i<avab->fallbacks->size() && voids>0; i++) {
+        fallback.loadFile(avab->fallbacks->at(i), HGT_SOURCE_SIZE_SRTM, HGT_SOURCE_SIZE_SRTM);
+        voids = hgt->fillVoids(&fallback);
     }
 }
 
@@ -365,6 +511,37 @@ void CCacheManager::convertCartesianToLonLat(const double &lonX, const double &l
     (*lat) = 90.0 - latY;
 }
 
+QList<int> CCacheManager::getIndexesInBox(const double &degreeSize, double minLon, double minLat, double maxLon, double maxLat)
+{
+    QList<int> indexes;
+    int width  = (int)( (360.0 / degreeSize) + 0.5 );
+    int height = (int)( (180.0 / degreeSize) + 0.5 );
+    int minX, maxX, minY, maxY;
+    int x, y;
+
+    // longitude -180..360, box crossing 180/360 meridian wraps around
+    if (maxLon - minLon >= 360.0) {
+        minX = 0;
+        maxX = width - 1;
+    } else {
+        if (minLon<0.0) minLon += 360.0;
+        if (maxLon<0.0) maxLon += 360.0;
+        minX = (int)floor(minLon / degreeSize);
+        maxX = qMax((int)ceil(maxLon / degreeSize) - 1, minX);
+        if (maxLon<minLon) maxX = (int)ceil(maxLon / degreeSize) - 1 + width;
+    }
+
+    // tiles only touching box border are not included
+    minY = qMax((int)floor((90.0 - maxLat) / degreeSize), 0);
+    maxY = qMin(qMax((int)ceil((90.0 - minLat) / degreeSize) - 1, minY), height - 1);
+
+    for (y=minY; y<=maxY; y++)
+        for (x=minX; x<=maxX; x++)
+            indexes.append(y*width + (x % width));
+
+    return indexes;
+}
+
 int CCacheManager::getNeighborAvabilityIndex(const int &baseIndex, const double &degreeSize, const int &dx, const int &dy)
 {
     int baseX, baseY;
@@ -389,3 +566,68 @@ int CCacheManager::getNeighborAvabilityIndex(const int &baseIndex, const double
 }
 
 
+
+CAvability *CCacheManager::getAvability(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return avability_L00_L03;
+        case HGT_SOURCE_L04_L08: return avability_L04_L08;
+        case HGT_SOURCE_L09_L13: return avability_L09_L13;
+        case HGT_SOURCE_SRTM:    return avability_SRTM;
+    }
+    return 0;
+}
+
+CHgtArchive *CCacheManager::getArchive(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return archive_L00_L03;
+        case HGT_SOURCE_L04_L08: return archive_L04_L08;
+        case HGT_SOURCE_L09_L13: return archive_L09_L13;
+    }
+    return 0;
+}
+
+QString CCacheManager::getPath(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return pathL00_L03;
+        case HGT_SOURCE_L04_L08: return pathL04_L08;
+        case HGT_SOURCE_L09_L13: return pathL09_L13;
+        case HGT_SOURCE_SRTM:    return pathSRTM;
+    }
+    return "";
+}
+
+QString CCacheManager::getIndexPath(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return pathL00_L03_index;
+        case HGT_SOURCE_L04_L08: return pathL04_L08_index;
+        case HGT_SOURCE_L09_L13: return pathL09_L13_index;
+        case HGT_SOURCE_SRTM:    return pathSRTM_index;
+    }
+    return "";
+}
+
+int CCacheManager::getSourceSize(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return HGT_SOURCE_SIZE_L00_L03;
+        case HGT_SOURCE_L04_L08: return HGT_SOURCE_SIZE_L04_L08;
+        case HGT_SOURCE_L09_L13: return HGT_SOURCE_SIZE_L09_L13;
+        case HGT_SOURCE_SRTM:    return HGT_SOURCE_SIZE_SRTM;
+    }
+    return 0;
+}
+
+double CCacheManager::getSourceDegreeSize(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return HGT_SOURCE_DEGREE_SIZE_L00_L03;
+        case HGT_SOURCE_L04_L08: return HGT_SOURCE_DEGREE_SIZE_L04_L08;
+        case HGT_SOURCE_L09_L13: return HGT_SOURCE_DEGREE_SIZE_L09_L13;
+        case HGT_SOURCE_SRTM:    return HGT_SOURCE_DEGREE_SIZE_SRTM;
+    }
+    return 0.0;
+}
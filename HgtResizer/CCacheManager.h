@@ -39,8 +39,13 @@
 #define CCACHEMANAGER_H
 
 #include <QString>
+#include <QStringList>
+#include <QList>
 #include "CAvability.h"
 
+class CHgtFile;
+class CHgtArchive;
+
 #define HGT_SOURCE_L00_L03                 0
 #define HGT_SOURCE_L04_L08                 1
 #define HGT_SOURCE_L09_L13                 2
@@ -65,10 +70,14 @@ public:
     QString pathL04_L08;
     QString pathL09_L13;
     QString pathSRTM;
+    QStringList pathSRTMroots;       // SRTM directories, highest priority first, pathSRTM if no config
+    QString pathSRTMconfig;          // roots and per tile overrides, see setupSRTMroots
+    QStringList SRTMoverrides;
     QString pathL00_L03_index;
     QString pathL04_L08_index;
     QString pathL09_L13_index;
     QString pathSRTM_index;
+    QString pathXYZ;
     double LODdegreeSizeLookUp[14];
     int HGTsourceLookUp[14];
     double HGTsourceDegreeSizeLookUp[14];
@@ -80,8 +89,14 @@ public:
     CAvability *avability_L09_L13;    // tile size =  3.75 deg
     CAvability *avability_SRTM;       // tile size =  1.00 deg
 
+    CHgtArchive *archive_L00_L03;     // tiles not found as loose files are read from archives
+    CHgtArchive *archive_L04_L08;
+    CHgtArchive *archive_L09_L13;
+
     CCacheManager();
     static CCacheManager *getInstance();
+    void setupPaths(const QString &inputRoot, const QString &outputRoot);
+    static QString addSeparator(const QString &dir);     // directory ready for appending file name
 
     void findTopLeftCorner(const double &lon, const double &lat, const double &degreeSize, double *tlLon, double *tlLat);
     void findTopLeftCornerOfHgtFile(const double &lon, const double &lat, const int &lod, double *tlLon, double *tlLat);
@@ -95,7 +110,17 @@ public:
     void convertLonLatToCartesian(const double &lon, const double &lat, double *lonX, double *latY);
     void convertCartesianToLonLat(const double &lonX, const double &latY, double *lon, double *lat);
     void setupAvabilityTables();
+    void setupSRTMroots();
+    void setupArchive(int hgtSource);
+    void loadSRTMFile(int index, CHgtFile *hgt);
+    QList<int> getIndexesInBox(const double &degreeSize, double minLon, double minLat, double maxLon, double maxLat);
     int getNeighborAvabilityIndex(const int &baseIndex, const double &degreeSize, const int &dx, const int &dy);
+    CAvability *getAvability(int hgtSource);
+    CHgtArchive *getArchive(int hgtSource);
+    QString getPath(int hgtSource);
+    QString getIndexPath(int hgtSource);
+    int getSourceSize(int hgtSource);
+    double getSourceDegreeSize(int hgtSource);
 };
 
 #endif // CCACHEMANAGER_H
@@ -0,0 +1,288 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDebug>
+#include <QDataStream>
+#include <QDir>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include "CHgtArchive.h"
+#include "CHgtFile.h"
+#include "CCacheManager.h"
+#include "CLog.h"
+
+CHgtArchive::CHgtArchive()
+{
+    hgtSource = 0;
+    count = 0;
+    offset = 0;
+    length = 0;
+}
+
+CHgtArchive::~CHgtArchive()
+{
+    close();
+}
+
+QString CHgtArchive::getFileName(int hgtSource)
+{
+    return CCacheManager::getInstance()->getPath(hgtSource) + HGT_ARCHIVE_FILENAME;
+}
+
+bool CHgtArchive::open(QString name)
+{
+    quint32 magic, n, reserved;
+    quint16 version, src;
+    int i;
+
+    close();
+    file.setFileName(name);
+    if ( ! file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in >> magic >> version >> src >> n >> reserved;
+    if (magic!=HGT_ARCHIVE_MAGIC || version!=HGT_ARCHIVE_VERSION) {
+        file.close();
+        return false;
+    }
+
+    hgtSource = src;
+    count = (int)n;
+    offset = new quint64[count];
+    length = new quint64[count];
+    for (i=0; i<count; i++)
+        in >> offset[i] >> length[i];
+
+    if (in.status()!=QDataStream::Ok) {
+        close();
+        return false;
+    }
+
+    // truncated archive would give short reads of tiles later
+    for (i=0; i<count; i++)
+        if (length[i]!=0 && offset[i] + length[i]>(quint64)file.size()) {
+            close();
+            return false;
+        }
+
+    return true;
+}
+
+void CHgtArchive::close()
+{
+    if (file.isOpen())
+        file.close();
+    if (offset!=0)
+        delete []offset;
+    if (length!=0)
+        delete []length;
+
+    offset = 0;
+    length = 0;
+    count = 0;
+}
+
+bool CHgtArchive::readTile(int index, char *data)
+{
+    qint64 position, size, done;
+#ifdef Q_OS_WIN
+    OVERLAPPED overlapped;
+    DWORD n;
+#else
+    ssize_t n;
+#endif
+
+    if ( ! contains(index)) return false;
+
+    // read at offset leaves file position alone, no lock between readers
+    position = (qint64)offset[index];
+    size = (qint64)length[index];
+    done = 0;
+    while (done<size) {
+#ifdef Q_OS_WIN
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)((position + done) & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)((position + done) >> 32);
+        if ( ! ReadFile((HANDLE)_get_osfhandle(file.handle()), data + done,
+                        (DWORD)qMin(size - done, (qint64)0x40000000), &n, &overlapped) || n==0)
+            return false;
+#else
+        n = pread(file.handle(), data + done, (size_t)(size - done), (off_t)(position + done));
+        if (n<0 && errno==EINTR) continue;
+        if (n<=0) return false;
+#endif
+        done += n;
+    }
+
+    return true;
+}
+
+bool CHgtArchive::pack(int hgtSource)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    CAvability *avab = cacheManager->getAvability(hgtSource);
+    QString pathDir = cacheManager->getPath(hgtSource);
+    QString name = getFileName(hgtSource);
+    double degreeSize = cacheManager->getSourceDegreeSize(hgtSource);
+    int n = ((int)(360.0 / degreeSize)) * ((int)(180.0 / degreeSize));
+    quint64 *offset = new quint64[n];
+    quint64 *length = new quint64[n];
+    quint64 position;
+    QFile out(name + ".tmp");
+    QFile tile;
+    QByteArray data;
+    int i, tiles;
+    bool ok;
+
+    if ( ! out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR << "Can't write" << name + ".tmp";
+        delete []offset;
+        delete []length;
+        return false;
+    }
+
+    // index first, payloads start at first aligned position after it
+    position = HGT_ARCHIVE_HEADER_SIZE + (quint64)n*16;
+    position = ((position + HGT_ARCHIVE_ALIGN - 1) / HGT_ARCHIVE_ALIGN) * HGT_ARCHIVE_ALIGN;
+    tiles = 0;
+    ok = true;
+    for (i=0; i<n && ok; i++) {
+        offset[i] = 0;
+        length[i] = 0;
+        if ( ! avab[i].available) continue;
+
+        // tiles only in current archive are copied from it, tile that can't
+        // be read fails whole pack instead of missing in archive
+        if (avab[i].archive!=0) {
+            data.resize((int)avab[i].archive->getLength(avab[i].archiveIndex));
+            ok = avab[i].archive->readTile(avab[i].archiveIndex, data.data());
+        } else {
+            tile.setFileName(avab[i].getFilePath(pathDir));
+            ok = tile.open(QIODevice::ReadOnly);
+            if (ok) {
+                data = tile.readAll();
+                ok = (data.size()==tile.size());
+                tile.close();
+            }
+        }
+        if ( ! ok) {
+            LOG_ERROR << "Can't read tile" << i << *avab[i].name;
+            break;
+        }
+
+        ok = out.seek((qint64)position) && out.write(data)==(qint64)data.size();
+        offset[i] = position;
+        length[i] = data.size();
+        position = ((position + length[i] + HGT_ARCHIVE_ALIGN - 1) / HGT_ARCHIVE_ALIGN) * HGT_ARCHIVE_ALIGN;
+        tiles++;
+    }
+
+    if (ok) {
+        ok = out.seek(0);
+        QDataStream header(&out);
+        header << (quint32)HGT_ARCHIVE_MAGIC << (quint16)HGT_ARCHIVE_VERSION
+               << (quint16)hgtSource << (quint32)n << (quint32)0;
+        for (i=0; i<n; i++)
+            header << offset[i] << length[i];
+        // archive is complete on disk before it replaces old one
+        ok = ok && header.status()==QDataStream::Ok && CHgtFile::syncFile(&out);
+    }
+    out.close();
+
+    delete []offset;
+    delete []length;
+
+    if ( ! ok) {
+        LOG_ERROR << "Can't write" << name + ".tmp";
+        QFile::remove(name + ".tmp");
+        return false;
+    }
+
+    // archive of avability tables is replaced and opened again
+    if (cacheManager->getArchive(hgtSource)!=0)
+        cacheManager->getArchive(hgtSource)->close();
+    // old archive stays in place until new one replaces it atomically
+    if ( ! CHgtFile::replaceFile(name + ".tmp", name)) {
+        LOG_ERROR << "Can't replace" << name;
+        QFile::remove(name + ".tmp");
+        cacheManager->setupArchive(hgtSource);
+        return false;
+    }
+    cacheManager->setupArchive(hgtSource);
+
+    LOG_INFO << "Packed" << tiles << "tiles to" << name;
+    return true;
+}
+
+bool CHgtArchive::unpack(int hgtSource)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    QString pathDir = cacheManager->getPath(hgtSource);
+    double degreeSize = cacheManager->getSourceDegreeSize(hgtSource);
+    CHgtArchive archive;
+    QString filename;
+    QByteArray data;
+    double tlLon, tlLat;
+    int i, tiles;
+
+    if ( ! archive.open(getFileName(hgtSource))) return false;
+
+    tiles = 0;
+    for (i=0; i<archive.getCount(); i++) {
+        if ( ! archive.contains(i)) continue;
+
+        cacheManager->convertAvabilityIndex2TopLeft(i, degreeSize, &tlLon, &tlLat);
+        cacheManager->convertLonLatToFileName(tlLon, tlLat, &filename);
+
+        // loose tile is complete or not there, archive stays until all are out
+        data.resize((int)archive.getLength(i));
+        if ( ! archive.readTile(i, data.data())) {
+            LOG_ERROR << "Can't read tile" << i << "from" << getFileName(hgtSource);
+            return false;
+        }
+        if ( ! CHgtFile::writeFileAtomic(pathDir + filename, data.data(), (qint64)data.size())) return false;
+        tiles++;
+    }
+
+    LOG_INFO << "Unpacked" << tiles << "tiles to" << pathDir;
+    return true;
+}
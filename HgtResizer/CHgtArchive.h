@@ -0,0 +1,82 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CHGTARCHIVE_H
+#define CHGTARCHIVE_H
+
+#include <QString>
+#include <QFile>
+
+#define HGT_ARCHIVE_MAGIC         0x48475441      // 'HGTA'
+#define HGT_ARCHIVE_VERSION       1
+#define HGT_ARCHIVE_HEADER_SIZE   16
+#define HGT_ARCHIVE_ALIGN         4096
+#define HGT_ARCHIVE_FILENAME      "tiles.hga"
+
+// Per level container of tiles: header (magic, version, hgtSource, count,
+// reserved) and index of count (offset, length) pairs keyed by avability
+// index, big endian. Tile payloads are copies of loose .hgt files (raw or
+// encoded) aligned to HGT_ARCHIVE_ALIGN, length 0 means no tile.
+class CHgtArchive
+{
+public:
+    CHgtArchive();
+    ~CHgtArchive();
+
+    bool open(QString name);
+    void close();
+    bool contains(int index) { return (index>=0 && index<count && length[index]!=0); }
+    qint64 getLength(int index) { return (qint64)length[index]; }
+    int getCount() { return count; }
+    int getHgtSource() { return hgtSource; }
+    QString getName() { return file.fileName(); }
+    // positioned read, any number of threads read at once
+    bool readTile(int index, char *data);
+
+    static QString getFileName(int hgtSource);
+    static bool pack(int hgtSource);
+    static bool unpack(int hgtSource);
+
+private:
+    QFile file;
+    int hgtSource;
+    int count;
+    quint64 *offset;
+    quint64 *length;
+};
+
+#endif // CHGTARCHIVE_H
@@ -0,0 +1,693 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <string.h>
+#include <QDebug>
+#include "CHgtCodec.h"
+#include "CLog.h"
+
+bool CHgtCodec::isConstant(const quint16 *height, int stride, int w, int h)
+{
+    quint16 v = height[0];
+    int x, y, diff;
+
+    // whole row without early exit, compiler vectorizes it
+    diff = 0;
+    for (y=0; y<h && diff==0; y++)
+        for (x=0; x<w; x++)
+            diff |= (height[y*stride + x] ^ v);
+
+    return (diff==0);
+}
+
+qint64 CHgtCodec::encode(const quint16 *height, int sizeX, int sizeY, int encoding, char **data, int maxError)
+{
+    qint64 rawSize = (qint64)sizeX*sizeY*2;
+    qint64 size = 0;
+    qint64 capacity, otherSize;
+    char *out, *other;
+    int error;
+
+    (*data) = 0;
+    if (encoding==HGT_ENCODING_RAW)
+        return 0;
+
+    // worst case of all encodings is below raw size + header + block flags
+    // or group widths + predictors + chunk table
+    capacity = rawSize + rawSize/8 + 4*sizeY + 64;
+    out = new char[HGT_CODEC_HEADER_SIZE + capacity];
+
+    if (isConstant(height, sizeX, sizeX, sizeY)) {
+        encoding = HGT_ENCODING_CONSTANT;
+        putU16(out + HGT_CODEC_HEADER_SIZE, height[0]);
+        size = HGT_CODEC_HEADER_SIZE + 2;
+    } else if (encoding==HGT_ENCODING_SPARSE) {
+        size = HGT_CODEC_HEADER_SIZE + encodeSparse(height, sizeX, sizeY, out + HGT_CODEC_HEADER_SIZE);
+    } else if (encoding==HGT_ENCODING_DELTA) {
+        size = HGT_CODEC_HEADER_SIZE + encodeDelta(height, sizeX, sizeY, 1, out + HGT_CODEC_HEADER_SIZE);
+    } else if (encoding==HGT_ENCODING_LOSSY) {
+        // error bound holds by construction, verifier guards against bugs
+        maxError = qBound(1, maxError, HGT_CODEC_MAX_ERROR);
+        putU16(out + HGT_CODEC_HEADER_SIZE, (quint16)maxError);
+        size = HGT_CODEC_HEADER_SIZE + 2 + encodeDelta(height, sizeX, sizeY, 2*maxError + 1, out + HGT_CODEC_HEADER_SIZE + 2);
+        writeHeader(out, encoding, sizeX, sizeY);
+        error = verify(height, out, size, sizeX, sizeY);
+        if (error<0 || error>maxError) {
+            LOG_WARNING << "Lossy encoding error" << error << "over" << maxError << ", saved lossless";
+            encoding = HGT_ENCODING_DELTA;
+            size = HGT_CODEC_HEADER_SIZE + encodeDelta(height, sizeX, sizeY, 1, out + HGT_CODEC_HEADER_SIZE);
+        }
+    } else if (encoding==HGT_ENCODING_AUTO) {
+        // sparse wins on sea with a few islands, delta on land
+        encoding = HGT_ENCODING_SPARSE;
+        size = HGT_CODEC_HEADER_SIZE + encodeSparse(height, sizeX, sizeY, out + HGT_CODEC_HEADER_SIZE);
+        other = new char[capacity];
+        otherSize = HGT_CODEC_HEADER_SIZE + encodeDelta(height, sizeX, sizeY, 1, other);
+        if (otherSize<size) {
+            encoding = HGT_ENCODING_DELTA;
+            size = otherSize;
+            memcpy(out + HGT_CODEC_HEADER_SIZE, other, size - HGT_CODEC_HEADER_SIZE);
+        }
+        delete []other;
+    }
+
+    if (size==0 || size>=rawSize) {
+        delete []out;
+        return 0;
+    }
+
+    writeHeader(out, encoding, sizeX, sizeY);
+    (*data) = out;
+
+    return size;
+}
+
+void CHgtCodec::writeHeader(char *data, int encoding, int sizeX, int sizeY)
+{
+    putU32(data, HGT_CODEC_MAGIC);
+    putU16(data + 4, HGT_CODEC_VERSION);
+    putU16(data + 6, (quint16)encoding);
+    putU32(data + 8, (quint32)sizeX);
+    putU32(data + 12, (quint32)sizeY);
+}
+
+bool CHgtCodec::readHeader(const char *data, qint64 length, int *encoding, int *sizeX, int *sizeY)
+{
+    if (length<HGT_CODEC_HEADER_SIZE) return false;
+    if (getU32(data)!=HGT_CODEC_MAGIC || getU16(data + 4)!=HGT_CODEC_VERSION) return false;
+
+    (*encoding) = getU16(data + 6);
+    (*sizeX) = (int)getU32(data + 8);
+    (*sizeY) = (int)getU32(data + 12);
+
+    return true;
+}
+
+qint64 CHgtCodec::getIndexSize(int sizeY)
+{
+    // header, maximum error of lossy tile and chunk offsets
+    return HGT_CODEC_HEADER_SIZE + 2 + 4*((sizeY + HGT_CODEC_CHUNK_ROWS - 1) / HGT_CODEC_CHUNK_ROWS + 1);
+}
+
+bool CHgtCodec::getReadRanges(const char *index, qint64 indexLength, qint64 length, int sizeX, int sizeY,
+                              int rowSkip, QVector<qint64> *ranges)
+{
+    int chunks = (sizeY + HGT_CODEC_CHUNK_ROWS - 1) / HGT_CODEC_CHUNK_ROWS;
+    int encoding, sX, sY, c, first, last;
+    qint64 table, base, start, stop;
+
+    if (rowSkip<=1 || ! readHeader(index, indexLength, &encoding, &sX, &sY)) return false;
+    if (sX!=sizeX || sY!=sizeY) return false;
+    if (encoding==HGT_ENCODING_DELTA) table = HGT_CODEC_HEADER_SIZE; else
+    if (encoding==HGT_ENCODING_LOSSY) table = HGT_CODEC_HEADER_SIZE + 2; else
+        return false;
+
+    base = table + 4*(chunks + 1);
+    if (indexLength<base || base + getU32(index + table + 4*chunks)>length) return false;
+
+    // same chunks and rows as decodeDelta decodes
+    ranges->clear();
+    for (c=0; c<chunks; c++) {
+        first = c*HGT_CODEC_CHUNK_ROWS;
+        last = qMin(first + HGT_CODEC_CHUNK_ROWS, sizeY) - 1;
+        last = last - last%rowSkip;
+        if (last<first) continue;
+
+        start = base + getU32(index + table + 4*c);
+        stop = base + getU32(index + table + 4*(c + 1));
+        if (start<base || stop<start || stop>length) return false;
+        ranges->append(start);
+        ranges->append(stop - start);
+    }
+
+    return true;
+}
+
+bool CHgtCodec::decode(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY, int rowSkip)
+{
+    int encoding, sX, sY, i;
+    quint16 v;
+
+    if ( ! readHeader(data, length, &encoding, &sX, &sY)) return false;
+    if (sX!=sizeX || sY!=sizeY) return false;
+    data += HGT_CODEC_HEADER_SIZE;
+    length -= HGT_CODEC_HEADER_SIZE;
+
+    switch (encoding) {
+        case HGT_ENCODING_CONSTANT:
+            if (length<2) return false;
+            v = getU16(data);
+            for (i=0; i<sizeX*sizeY; i++)
+                height[i] = v;
+            return true;
+        case HGT_ENCODING_SPARSE:
+            return decodeSparse(data, length, height, sizeX, sizeY);
+        case HGT_ENCODING_DELTA:
+            return decodeDelta(data, length, height, sizeX, sizeY, 1, rowSkip);
+        case HGT_ENCODING_LOSSY:
+            if (length<2) return false;
+            return decodeDelta(data + 2, length - 2, height, sizeX, sizeY, 2*getU16(data) + 1, rowSkip);
+    }
+
+    return false;
+}
+
+qint64 CHgtCodec::encodeSparse(const quint16 *height, int sizeX, int sizeY, char *out)
+{
+    int blocksX = (sizeX + HGT_CODEC_BLOCK - 1) / HGT_CODEC_BLOCK;
+    int blocksY = (sizeY + HGT_CODEC_BLOCK - 1) / HGT_CODEC_BLOCK;
+    char *flags = out;
+    char *p = out + blocksX*blocksY;
+    int bx, by, x, y, w, h;
+    const quint16 *block;
+
+    for (by=0; by<blocksY; by++)
+        for (bx=0; bx<blocksX; bx++) {
+            w = qMin(HGT_CODEC_BLOCK, sizeX - bx*HGT_CODEC_BLOCK);
+            h = qMin(HGT_CODEC_BLOCK, sizeY - by*HGT_CODEC_BLOCK);
+            block = height + (by*HGT_CODEC_BLOCK)*sizeX + bx*HGT_CODEC_BLOCK;
+
+            if (isConstant(block, sizeX, w, h)) {
+                flags[by*blocksX + bx] = 0;
+                putU16(p, block[0]);
+                p += 2;
+            } else {
+                flags[by*blocksX + bx] = 1;
+                for (y=0; y<h; y++)
+                    for (x=0; x<w; x++) {
+                        putU16(p, block[y*sizeX + x]);
+                        p += 2;
+                    }
+            }
+        }
+
+    return p - out;
+}
+
+bool CHgtCodec::decodeSparse(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY)
+{
+    int blocksX = (sizeX + HGT_CODEC_BLOCK - 1) / HGT_CODEC_BLOCK;
+    int blocksY = (sizeY + HGT_CODEC_BLOCK - 1) / HGT_CODEC_BLOCK;
+    const char *flags = data;
+    const char *p = data + blocksX*blocksY;
+    const char *end = data + length;
+    int bx, by, x, y, w, h;
+    quint16 *block;
+    quint16 v;
+
+    if (length<blocksX*blocksY) return false;
+
+    for (by=0; by<blocksY; by++)
+        for (bx=0; bx<blocksX; bx++) {
+            w = qMin(HGT_CODEC_BLOCK, sizeX - bx*HGT_CODEC_BLOCK);
+            h = qMin(HGT_CODEC_BLOCK, sizeY - by*HGT_CODEC_BLOCK);
+            block = height + (by*HGT_CODEC_BLOCK)*sizeX + bx*HGT_CODEC_BLOCK;
+
+            if (flags[by*blocksX + bx]==0) {
+                if (p+2>end) return false;
+                v = getU16(p);
+                p += 2;
+                for (y=0; y<h; y++)
+                    for (x=0; x<w; x++)
+                        block[y*sizeX + x] = v;
+            } else {
+                if (p + 2*w*h > end) return false;
+                for (y=0; y<h; y++)
+                    for (x=0; x<w; x++) {
+                        block[y*sizeX + x] = getU16(p);
+                        p += 2;
+                    }
+            }
+        }
+
+    return true;
+}
+
+int CHgtCodec::verify(const quint16 *height, const char *data, qint64 length, int sizeX, int sizeY)
+{
+    quint16 *decoded = new quint16[sizeX*sizeY];
+    int i, error, encoding, sX, sY, h;
+
+    if ( ! decode(data, length, decoded, sizeX, sizeY)) {
+        delete []decoded;
+        return -1;
+    }
+
+    // lossy tile holds any void as HGT_CODEC_VOID
+    readHeader(data, length, &encoding, &sX, &sY);
+    error = 0;
+    for (i=0; i<sizeX*sizeY; i++) {
+        h = (encoding==HGT_ENCODING_LOSSY && height[i]>HGT_CODEC_MAX_HEIGHT) ? HGT_CODEC_VOID : height[i];
+        error = qMax(error, qAbs((int)decoded[i] - h));
+    }
+
+    delete []decoded;
+    return error;
+}
+
+void CHgtCodec::predictRow(const quint16 *row, const quint16 *up, int n, int predictor, quint16 *prediction)
+{
+    int x, a, b, c, p, pa, pb, pc;
+
+    // first row of chunk: only left neighbour, row starts from 0
+    if (up==0) {
+        prediction[0] = 0;
+        for (x=1; x<n; x++)
+            prediction[x] = row[x-1];
+        return;
+    }
+
+    // first sample has only up neighbour for all predictors
+    prediction[0] = up[0];
+    switch (predictor) {
+        case HGT_PREDICT_LEFT:
+            for (x=1; x<n; x++)
+                prediction[x] = row[x-1];
+            break;
+        case HGT_PREDICT_UP:
+            for (x=1; x<n; x++)
+                prediction[x] = up[x];
+            break;
+        case HGT_PREDICT_PAETH:
+            for (x=1; x<n; x++) {
+                a = row[x-1];
+                b = up[x];
+                c = up[x-1];
+                p = a + b - c;
+                pa = qAbs(p - a);
+                pb = qAbs(p - b);
+                pc = qAbs(p - c);
+                prediction[x] = (quint16)((pa<=pb && pa<=pc) ? a : ((pb<=pc) ? b : c));
+            }
+            break;
+        case HGT_PREDICT_GRADIENT:
+            for (x=1; x<n; x++)
+                prediction[x] = (quint16)(row[x-1] + up[x] - up[x-1]);
+            break;
+    }
+}
+
+char *CHgtCodec::packGroup(const quint16 *residual, int n, char *p)
+{
+    quint64 acc;
+    int i, width, bits, any;
+
+    any = 0;
+    for (i=0; i<n; i++)
+        any |= residual[i];
+    for (width=0; (any >> width)!=0; width++) ;
+
+    (*p++) = (char)width;
+    if (width==0) return p;
+
+    acc = 0;
+    bits = 0;
+    for (i=0; i<n; i++) {
+        acc |= ((quint64)residual[i]) << bits;
+        bits += width;
+        while (bits>=8) {
+            (*p++) = (char)(acc & 0xFF);
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits>0)
+        (*p++) = (char)(acc & 0xFF);
+
+    return p;
+}
+
+const char *CHgtCodec::unpackGroup(const char *p, const char *end, int n, quint16 *residual)
+{
+    const uchar *q;
+    quint64 acc, mask;
+    int i, width, bits;
+
+    if (p>=end) return 0;
+    width = (uchar)(*p++);
+    if (width>16 || p + (n*width + 7)/8 > end) return 0;
+
+    if (width==0) {
+        for (i=0; i<n; i++)
+            residual[i] = 0;
+        return p;
+    }
+
+    mask = (1 << width) - 1;
+
+    // each residual from its own 3 bytes (width + shift <= 23 bits), no
+    // dependency between samples; reading 2 bytes past group needs space
+    if (p + (n*width)/8 + 3 <= end) {
+        for (i=0; i<n; i++) {
+            bits = i*width;
+            q = (const uchar *)p + (bits >> 3);
+            residual[i] = (quint16)(((q[0] | (q[1] << 8) | (q[2] << 16)) >> (bits & 7)) & mask);
+        }
+        return p + (n*width + 7)/8;
+    }
+
+    acc = 0;
+    bits = 0;
+    for (i=0; i<n; i++) {
+        while (bits<width) {
+            acc |= ((quint64)(uchar)(*p++)) << bits;
+            bits += 8;
+        }
+        residual[i] = (quint16)(acc & mask);
+        acc >>= width;
+        bits -= width;
+    }
+
+    return p;
+}
+
+int CHgtCodec::predictSample(int a, int b, int c, int predictor)
+{
+    int p, pa, pb, pc;
+
+    switch (predictor) {
+        case HGT_PREDICT_UP:
+            return b;
+        case HGT_PREDICT_PAETH:
+            p = a + b - c;
+            pa = qAbs(p - a);
+            pb = qAbs(p - b);
+            pc = qAbs(p - c);
+            return (pa<=pb && pa<=pc) ? a : ((pb<=pc) ? b : c);
+        case HGT_PREDICT_GRADIENT:
+            return qBound(0, a + b - c, 65535);
+    }
+
+    return a;
+}
+
+void CHgtCodec::quantizeRow(const quint16 *row, const quint16 *up, int n, int predictor, int step,
+                            quint16 *residual, quint16 *recon)
+{
+    int x, pred, r, q, v;
+    int maxError = (step - 1) / 2;
+    int voidValue = HGT_CODEC_MAX_HEIGHT + 2*maxError + 1;
+
+    // prediction from reconstructed values, so quantization error does not
+    // accumulate along the row (error feedback); recon is coded value
+    for (x=0; x<n; x++) {
+        if (up==0)
+            pred = (x==0) ? 0 : recon[x-1]; else
+        if (x==0)
+            pred = up[0]; else
+            pred = predictSample(recon[x-1], up[x], up[x-1], predictor);
+
+        if (row[x]==0) {
+            // sea, any value <= 0 is clamped to 0
+            q = -((pred + step - 1) / step);
+        } else if (row[x]>HGT_CODEC_MAX_HEIGHT) {
+            // void, any value >= voidValue
+            q = (pred>=voidValue) ? 0 : (voidValue - pred + step - 1) / step;
+        } else {
+            // land coded as height + maxError, value within maxError of it is >= 1
+            r = (int)row[x] + maxError - pred;
+            q = (r>=0) ? (r + maxError) / step : -((maxError - r) / step);
+        }
+        v = qBound(0, pred + q*step, 65535);
+
+        recon[x] = (quint16)v;
+        residual[x] = (quint16)((q << 1) ^ (q >> 31));
+    }
+}
+
+quint16 CHgtCodec::lossyHeight(int value, int maxError)
+{
+    if (value==0) return 0;
+    if (value>HGT_CODEC_MAX_HEIGHT + 2*maxError) return HGT_CODEC_VOID;
+
+    return (quint16)qBound(1, value - maxError, HGT_CODEC_MAX_HEIGHT);
+}
+
+void CHgtCodec::dequantizeRow(quint16 *row, const quint16 *up, int n, int predictor, int step, const quint16 *residual)
+{
+    int x, pred, q;
+
+    for (x=0; x<n; x++) {
+        if (up==0)
+            pred = (x==0) ? 0 : row[x-1]; else
+        if (x==0)
+            pred = up[0]; else
+            pred = predictSample(row[x-1], up[x], up[x-1], predictor);
+
+        q = (int)(residual[x] >> 1) ^ (-(int)(residual[x] & 1));
+        row[x] = (quint16)qBound(0, pred + q*step, 65535);
+    }
+}
+
+int CHgtCodec::packedBits(const quint16 *residual, int n)
+{
+    int x, i, len, any, width, bits;
+
+    bits = 0;
+    for (x=0; x<n; x+=HGT_CODEC_GROUP) {
+        len = qMin(HGT_CODEC_GROUP, n - x);
+        any = 0;
+        for (i=x; i<x+len; i++)
+            any |= residual[i];
+        for (width=0; (any >> width)!=0; width++) ;
+        bits += width*len + 8;
+    }
+
+    return bits;
+}
+
+void CHgtCodec::rowResiduals(const quint16 *row, const quint16 *up, int n, int predictor, int step,
+                             quint16 *prediction, quint16 *residual, quint16 *recon)
+{
+    qint16 d;
+    int x;
+
+    if (step>1) {
+        quantizeRow(row, up, n, predictor, step, residual, recon);
+        return;
+    }
+
+    // lossless residuals wrap around in 16 bits
+    predictRow(row, up, n, predictor, prediction);
+    for (x=0; x<n; x++) {
+        d = (qint16)(row[x] - prediction[x]);
+        residual[x] = (quint16)((d << 1) ^ (d >> 15));
+    }
+}
+
+qint64 CHgtCodec::encodeDelta(const quint16 *height, int sizeX, int sizeY, int step, char *out)
+{
+    int chunks = (sizeY + HGT_CODEC_CHUNK_ROWS - 1) / HGT_CODEC_CHUNK_ROWS;
+    char *base = out + 4*(chunks + 1);
+    char *p = base;
+    quint16 *prediction = new quint16[sizeX];
+    quint16 *residual = new quint16[sizeX];
+    quint16 *recon = new quint16[sizeX];
+    quint16 *reconUp = new quint16[sizeX];
+    quint16 *swap;
+    const quint16 *row, *up;
+    int cost, bestCost;
+    int x, y, predictor, best;
+
+    for (y=0; y<sizeY; y++) {
+        if (y%HGT_CODEC_CHUNK_ROWS==0)
+            putU32(out + 4*(y/HGT_CODEC_CHUNK_ROWS), (quint32)(p - base));
+
+        // lossy rows are predicted from what decoder will see
+        row = height + y*sizeX;
+        up = (step>1) ? reconUp : row - sizeX;
+        if (y%HGT_CODEC_CHUNK_ROWS==0) up = 0;
+
+        // predictor giving fewest packed bits
+        best = HGT_PREDICT_LEFT;
+        bestCost = 0;
+        for (predictor=HGT_PREDICT_LEFT; predictor<=HGT_PREDICT_GRADIENT; predictor++) {
+            if (up==0 && predictor!=HGT_PREDICT_LEFT) break;
+
+            rowResiduals(row, up, sizeX, predictor, step, prediction, residual, recon);
+            cost = packedBits(residual, sizeX);
+            if (predictor==HGT_PREDICT_LEFT || cost<bestCost) {
+                best = predictor;
+                bestCost = cost;
+            }
+        }
+
+        rowResiduals(row, up, sizeX, best, step, prediction, residual, recon);
+        swap = reconUp;
+        reconUp = recon;
+        recon = swap;
+
+        (*p++) = (char)best;
+        for (x=0; x<sizeX; x+=HGT_CODEC_GROUP)
+            p = packGroup(residual + x, qMin(HGT_CODEC_GROUP, sizeX - x), p);
+    }
+    putU32(out + 4*chunks, (quint32)(p - base));
+
+    delete []prediction;
+    delete []residual;
+    delete []recon;
+    delete []reconUp;
+
+    return p - out;
+}
+
+bool CHgtCodec::decodeDelta(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY, int step, int rowSkip)
+{
+    int chunks = (sizeY + HGT_CODEC_CHUNK_ROWS - 1) / HGT_CODEC_CHUNK_ROWS;
+    const char *base = data + 4*(chunks + 1);
+    const char *end, *p;
+    quint16 *residual = new quint16[sizeX];
+    quint16 *value = 0, *valueUp = 0;
+    quint16 *row, *up, *swap;
+    int c, y, x, first, last, predictor, a, b, cc, pr, pa, pb, pc;
+    bool ok = true;
+
+    if (length<4*(chunks + 1) || getU32(data + 4*chunks)>length - 4*(chunks + 1)) {
+        delete []residual;
+        return false;
+    }
+    end = base + getU32(data + 4*chunks);
+    if (step>1) {
+        value = new quint16[sizeX];
+        valueUp = new quint16[sizeX];
+    }
+
+    for (c=0; c<chunks && ok; c++) {
+        first = c*HGT_CODEC_CHUNK_ROWS;
+        last = qMin(first + HGT_CODEC_CHUNK_ROWS, sizeY) - 1;
+
+        // decimating reader needs chunk only up to its last wanted row
+        if (rowSkip>1) {
+            last = last - last%rowSkip;
+            if (last<first) continue;
+        }
+
+        p = base + getU32(data + 4*c);
+        for (y=first; y<=last && ok; y++) {
+            row = height + y*sizeX;
+            up = (y==first) ? 0 : row - sizeX;
+            if (p>=end) { ok = false; break; }
+            predictor = (uchar)(*p++);
+
+            for (x=0; x<sizeX && p!=0; x+=HGT_CODEC_GROUP)
+                p = unpackGroup(p, end, qMin(HGT_CODEC_GROUP, sizeX - x), residual + x);
+            if (p==0) { ok = false; break; }
+
+            if (step>1) {
+                // coded values predict next ones, heights are mapped from them
+                if (predictor>HGT_PREDICT_GRADIENT) { ok = false; break; }
+                dequantizeRow(value, (up==0) ? 0 : valueUp, sizeX, predictor, step, residual);
+                for (x=0; x<sizeX; x++)
+                    row[x] = lossyHeight(value[x], (step - 1) / 2);
+                swap = valueUp;
+                valueUp = value;
+                value = swap;
+                continue;
+            }
+
+            // zig-zag back to signed, heights wrap around in 16 bits
+            for (x=0; x<sizeX; x++)
+                residual[x] = (quint16)((residual[x] >> 1) ^ (-(residual[x] & 1)));
+
+            if (up==0) {
+                row[0] = residual[0];
+                for (x=1; x<sizeX; x++)
+                    row[x] = (quint16)(row[x-1] + residual[x]);
+                continue;
+            }
+
+            row[0] = (quint16)(up[0] + residual[0]);
+            switch (predictor) {
+                case HGT_PREDICT_LEFT:
+                    for (x=1; x<sizeX; x++)
+                        row[x] = (quint16)(row[x-1] + residual[x]);
+                    break;
+                case HGT_PREDICT_UP:
+                    for (x=1; x<sizeX; x++)
+                        row[x] = (quint16)(up[x] + residual[x]);
+                    break;
+                case HGT_PREDICT_PAETH:
+                    for (x=1; x<sizeX; x++) {
+                        a = row[x-1];
+                        b = up[x];
+                        cc = up[x-1];
+                        pr = a + b - cc;
+                        pa = qAbs(pr - a);
+                        pb = qAbs(pr - b);
+                        pc = qAbs(pr - cc);
+                        row[x] = (quint16)(((pa<=pb && pa<=pc) ? a : ((pb<=pc) ? b : cc)) + residual[x]);
+                    }
+                    break;
+                case HGT_PREDICT_GRADIENT:
+                    for (x=1; x<sizeX; x++)
+                        residual[x] = (quint16)(residual[x] + up[x] - up[x-1]);
+                    for (x=1; x<sizeX; x++)
+                        row[x] = (quint16)(row[x-1] + residual[x]);
+                    break;
+                default:
+                    ok = false;
+            }
+        }
+    }
+
+    delete []residual;
+    if (value!=0) {
+        delete []value;
+        delete []valueUp;
+    }
+    return ok;
+}
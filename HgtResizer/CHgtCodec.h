@@ -0,0 +1,130 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CHGTCODEC_H
+#define CHGTCODEC_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#define HGT_CODEC_MAGIC           0x48475445      // 'HGTE'
+#define HGT_CODEC_VERSION         1
+#define HGT_CODEC_HEADER_SIZE     16
+#define HGT_CODEC_BLOCK           64
+#define HGT_CODEC_CHUNK_ROWS      16
+#define HGT_CODEC_GROUP           32
+#define HGT_CODEC_MAX_ERROR      100
+#define HGT_CODEC_MAX_HEIGHT    9000     // higher heights are voids, as in CHgtFile::countVoids
+#define HGT_CODEC_VOID         32768     // -32768 of SRTM as quint16
+
+// tile encodings, raw is plain big endian HGT without header
+#define HGT_ENCODING_RAW          0
+#define HGT_ENCODING_CONSTANT     1
+#define HGT_ENCODING_SPARSE       2
+#define HGT_ENCODING_DELTA        3
+#define HGT_ENCODING_LOSSY        4
+#define HGT_ENCODING_AUTO       255     // smaller of sparse and delta, never stored
+
+// row predictors of delta encoding
+#define HGT_PREDICT_LEFT          0
+#define HGT_PREDICT_UP            1
+#define HGT_PREDICT_PAETH         2
+#define HGT_PREDICT_GRADIENT      3     // left + up - up left
+
+// Encoded HGT tile: 16 byte header (magic, version, encoding, sizeX, sizeY,
+// big endian) followed by payload of encoding:
+//  - constant:  one height
+//  - sparse:    tile split to HGT_CODEC_BLOCK x HGT_CODEC_BLOCK blocks, one
+//               flag byte per block (0 constant, 1 raw), then blocks in order,
+//               constant block as one height, raw block as all its heights
+//  - delta:     rows in chunks of HGT_CODEC_CHUNK_ROWS, table of chunkCount+1
+//               offsets (u32, from end of table), then chunks; chunk row is
+//               predictor byte and groups of HGT_CODEC_GROUP zig-zag residuals,
+//               each group a width byte and residuals bit-packed LSB first.
+//               First row of chunk has no up neighbour, so each chunk and
+//               first row of it can be decoded alone
+//  - lossy:     maximum absolute error e (u16) and delta payload of quantized
+//               residuals of coded values, value = prediction + residual*(2e+1)
+//               clamped to 0..65535, predictions made from decoded values.
+//               Value 0 is sea (0), values from 9001+2e are voids (32768),
+//               others are land height + e clamped to 1..9000, so sea and
+//               voids are exact and only land carries error up to e
+class CHgtCodec
+{
+public:
+    // Encoded size in bytes, 0 when raw file is smaller or the same. Constant
+    // tile is always encoded as constant one. data is allocated by encode
+    // with new[]. maxError is used by lossy encoding only.
+    static qint64 encode(const quint16 *height, int sizeX, int sizeY, int encoding, char **data, int maxError = 0);
+    // rowSkip>1 decodes at least rows y%rowSkip==0, other rows are undefined
+    static bool decode(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY, int rowSkip = 1);
+    static bool readHeader(const char *data, qint64 length, int *encoding, int *sizeX, int *sizeY);
+    // Bytes at start of file holding header and chunk table of any encoding
+    static qint64 getIndexSize(int sizeY);
+    // (offset, length) pairs of chunks decode with rowSkip>1 touches, read
+    // after first getIndexSize bytes. false when whole file is needed
+    static bool getReadRanges(const char *index, qint64 indexLength, qint64 length, int sizeX, int sizeY,
+                              int rowSkip, QVector<qint64> *ranges);
+    // maximum absolute error of encoded tile against height, -1 if not decodable
+    static int verify(const quint16 *height, const char *data, qint64 length, int sizeX, int sizeY);
+    // w x h block of rows stride samples apart has the same height everywhere
+    static bool isConstant(const quint16 *height, int stride, int w, int h);
+
+private:
+    static void putU16(char *p, quint16 v) { p[0] = (char)(v >> 8); p[1] = (char)(v & 0xFF); }
+    static void putU32(char *p, quint32 v) { putU16(p, (quint16)(v >> 16)); putU16(p + 2, (quint16)(v & 0xFFFF)); }
+    static quint16 getU16(const char *p) { return (quint16)((((uchar)p[0]) << 8) | ((uchar)p[1])); }
+    static quint32 getU32(const char *p) { return (((quint32)getU16(p)) << 16) | getU16(p + 2); }
+    static void writeHeader(char *data, int encoding, int sizeX, int sizeY);
+    static qint64 encodeSparse(const quint16 *height, int sizeX, int sizeY, char *out);
+    static bool decodeSparse(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY);
+    static void predictRow(const quint16 *row, const quint16 *up, int n, int predictor, quint16 *prediction);
+    static int predictSample(int a, int b, int c, int predictor);
+    static void quantizeRow(const quint16 *row, const quint16 *up, int n, int predictor, int step,
+                            quint16 *residual, quint16 *recon);
+    static void dequantizeRow(quint16 *row, const quint16 *up, int n, int predictor, int step, const quint16 *residual);
+    static quint16 lossyHeight(int value, int maxError);
+    static void rowResiduals(const quint16 *row, const quint16 *up, int n, int predictor, int step,
+                             quint16 *prediction, quint16 *residual, quint16 *recon);
+    static int packedBits(const quint16 *residual, int n);
+    static qint64 encodeDelta(const quint16 *height, int sizeX, int sizeY, int step, char *out);
+    static bool decodeDelta(const char *data, qint64 length, quint16 *height, int sizeX, int sizeY, int step, int rowSkip);
+    static char *packGroup(const quint16 *residual, int n, char *p);
+    static const char *unpackGroup(const char *p, const char *end, int n, quint16 *residual);
+};
+
+#endif // CHGTCODEC_H
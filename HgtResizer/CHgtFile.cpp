@@ -37,21 +37,46 @@
 
 #include <fstream>
 #include <iostream>
+#include <QFileInfo>
+#include <QFile>
+#include <QVector>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#endif
 #include "CHgtFile.h"
+#include "CHgtCodec.h"
+#include "CHgtArchive.h"
+#include "CAvability.h"
+#include "CTrace.h"
 
 using namespace std;
 
+int CHgtFile::saveEncoding = HGT_ENCODING_RAW;
+CHgtFileCounters CHgtFile::totalCounters;
+QMutex CHgtFile::countersMutex;
+
 CHgtFile::CHgtFile()
 {
     sizeX = 0;
     sizeY = 0;
     height = 0;
+    fileBuffer = 0;
+    fileModified = false;
+    saveMaxError = 0;
+    saveRaw = false;
 }
 
 CHgtFile::~CHgtFile()
 {
     if (height!=0)
         delete []height;
+    if (fileBuffer!=0)
+        delete []fileBuffer;
 }
 
 void CHgtFile::init(int sX, int sY)
@@ -78,6 +103,21 @@ void CHgtFile::exchangeEndian()
     }
 }
 
+CHgtFileCounters CHgtFile::getCounters()
+{
+    QMutexLocker locker(&countersMutex);
+    return totalCounters;
+}
+
+void CHgtFile::countIO(qint64 bytesRead, qint64 bytesWritten, qint64 seeks, qint64 fileOpens)
+{
+    QMutexLocker locker(&countersMutex);
+    totalCounters.bytesRead += bytesRead;
+    totalCounters.bytesWritten += bytesWritten;
+    totalCounters.seeks += seeks;
+    totalCounters.fileOpens += fileOpens;
+}
+
 void CHgtFile::savePGM(QString name)
 {
     if (height==0) return;
@@ -107,30 +147,271 @@ void CHgtFile::savePGM(QString name)
     filePGM.close();
 }
 
-void CHgtFile::saveFile(QString name)
+bool CHgtFile::syncFile(QFile *file)
 {
-    if (height==0) return;
-    fstream fileHgt;
+    // flush Qt and OS buffers, data is on disk when it returns true
+    if ( ! file->flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(file->handle())==0;
+#else
+    return fsync(file->handle())==0;
+#endif
+}
+
+bool CHgtFile::replaceFile(QString from, QString to)
+{
+#ifdef Q_OS_WIN
+    // write through returns after rename is on disk
+    return MoveFileExW((LPCWSTR)from.utf16(), (LPCWSTR)to.utf16(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)!=0;
+#else
+    int dir;
+    bool ok;
+
+    // rename over target is atomic, there is always old or new file; rename
+    // itself is durable after directory is synced
+    if (::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData())!=0) return false;
+    dir = ::open(QFile::encodeName(QFileInfo(to).absolutePath()).constData(), O_RDONLY);
+    if (dir<0) return false;
+    ok = (fsync(dir)==0);
+    ::close(dir);
+    return ok;
+#endif
+}
+
+bool CHgtFile::writeFileAtomic(QString name, const char *data, qint64 size)
+{
+    QFile file(name + ".tmp");
+    bool ok;
+
+    // crash leaves old file or complete new one, never torn tile
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cout << "Can't write " << name.toAscii().data() << endl;
+        return false;
+    }
+    ok = (file.write(data, size)==size) && syncFile(&file);
+    file.close();
+    countIO(0, size, 0, 1);
+    if ( ! ok) {
+        cout << "Can't write " << name.toAscii().data() << endl;
+        QFile::remove(name + ".tmp");
+        return false;
+    }
+
+    if ( ! replaceFile(name + ".tmp", name)) {
+        cout << "Can't replace " << name.toAscii().data() << endl;
+        QFile::remove(name + ".tmp");
+        return false;
+    }
+
+    return true;
+}
+
+qint64 CHgtFile::encodeBuffer(quint16 *buffer, char **data)
+{
+    // tiles are written encoded unless raw is smaller, 0 = write raw
+    (*data) = 0;
+    if (saveRaw) return 0;
+    if (saveMaxError>0)
+        return CHgtCodec::encode(buffer, sizeX, sizeY, HGT_ENCODING_LOSSY, data, saveMaxError);
+
+    return CHgtCodec::encode(buffer, sizeX, sizeY, saveEncoding, data);
+}
+
+bool CHgtFile::saveFile(QString name)
+{
+    char *data;
+    qint64 size;
+    bool ok;
+
+    if (height==0) return false;
+    CTraceScope trace("write");
+
+    size = encodeBuffer(height, &data);
+    if (size>0) {
+        ok = writeFileAtomic(name, data, size);
+        delete []data;
+        return ok;
+    }
 
     // save HGT file to disk
-    fileHgt.open(name.toAscii(), fstream::out | fstream::binary);
     exchangeEndian();
-    fileHgt.write((char *)height, sizeX*sizeY*2);
-    fileHgt.close();
+    return writeFileAtomic(name, (char *)height, (qint64)sizeX*sizeY*2);
+}
+
+bool CHgtFile::saveFileEncoded(QString name)
+{
+    char *data;
+    qint64 size;
+    bool ok;
+
+    if (height==0) return false;
+    // raw tile kept on purpose is not an error
+    if (saveEncoding==HGT_ENCODING_RAW) return true;
+    CTraceScope trace("write");
+
+    saveRaw = false;
+    size = encodeBuffer(height, &data);
+    if (size==0) return true;
+    ok = writeFileAtomic(name, data, size);
+    delete []data;
+
+    return ok;
 }
 
-void CHgtFile::loadFile(QString name, int x, int y)
+void CHgtFile::loadFile(QString name, int x, int y, int rowSkip)
 {
     init(x, y);
     fstream fileHgt;
+    QVector<qint64> ranges;
+    qint64 size, read;
+    char *data;
+    int row, i;
+    CTraceScope trace("read");
 
     // load HGT file to memory
+    size = QFileInfo(name).size();
     fileHgt.open(name.toAscii(), fstream::in | fstream::binary);
-    fileHgt.read((char *)height, sizeX*sizeY*2);
+    if (size!=(qint64)sizeX*sizeY*2 && size>=HGT_CODEC_HEADER_SIZE) {
+        data = new char[size];
+        read = qMin(size, CHgtCodec::getIndexSize(sizeY));
+        fileHgt.read(data, read);
+        if (CHgtCodec::getReadRanges(data, read, size, sizeX, sizeY, rowSkip, &ranges)) {
+            // decimating reader reads only chunks with wanted rows
+            for (i=0; i<ranges.size(); i+=2) {
+                fileHgt.seekg(ranges[i]);
+                fileHgt.read(data + ranges[i], ranges[i+1]);
+                read += ranges[i+1];
+            }
+        } else {
+            fileHgt.read(data + read, size - read);
+            read = size;
+        }
+        fileHgt.close();
+        if ( ! decodeBuffer(data, size, height, rowSkip))
+            cout << "Can't decode " << name.toAscii().data() << endl;
+        delete []data;
+        countIO(read, 0, ranges.size()/2, 1);
+        return;
+    }
+
+    if (rowSkip>1) {
+        // only wanted rows of raw file, others stay undefined
+        for (row=0; row<sizeY; row+=rowSkip) {
+            fileHgt.seekg((qint64)row*sizeX*2);
+            fileHgt.read((char *)(height + row*sizeX), sizeX*2);
+        }
+        countIO((qint64)((sizeY + rowSkip - 1) / rowSkip)*sizeX*2, 0, (sizeY + rowSkip - 1) / rowSkip, 1);
+    } else {
+        fileHgt.read((char *)height, sizeX*sizeY*2);
+        countIO((qint64)sizeX*sizeY*2, 0, 0, 1);
+    }
     exchangeEndian();
     fileHgt.close();
 }
 
+void CHgtFile::loadFile(CHgtArchive *archive, int index, int x, int y, int rowSkip)
+{
+    init(x, y);
+    qint64 size;
+    char *data;
+    CTraceScope trace("read", index);
+
+    // load tile stored in archive to memory
+    size = archive->getLength(index);
+    data = new char[size];
+    if ( ! archive->readTile(index, data) || ! decodeBuffer(data, size, height, rowSkip))
+        cout << "Can't read tile " << index << " from archive" << endl;
+    delete []data;
+    countIO(size, 0, 1, 0);
+}
+
+void CHgtFile::loadTile(CAvability *avab, QString defaultPath, int x, int y, int rowSkip)
+{
+    if (avab->archive!=0)
+        loadFile(avab->archive, avab->archiveIndex, x, y, rowSkip); else
+        loadFile(avab->getFilePath(defaultPath), x, y, rowSkip);
+}
+
+bool CHgtFile::decodeBuffer(const char *data, qint64 size, quint16 *buffer, int rowSkip)
+{
+    int i;
+
+    // raw tile or encoded one, buffer gets native endian heights
+    if (size==(qint64)sizeX*sizeY*2) {
+        for (i=0; i<sizeX*sizeY; i++)
+            buffer[i] = (quint16)((((uchar)data[2*i]) << 8) | ((uchar)data[2*i + 1]));
+        return true;
+    }
+
+    return CHgtCodec::decode(data, size, buffer, sizeX, sizeY, rowSkip);
+}
+
+bool CHgtFile::checkFile(QString name, qint64 fileSize, int sX, int sY)
+{
+    fstream fileHgt;
+    char header[HGT_CODEC_HEADER_SIZE];
+    int encoding, x, y;
+
+    if (fileSize==(qint64)sX*sY*2) return true;
+    if (fileSize<HGT_CODEC_HEADER_SIZE) return false;
+
+    fileHgt.open(name.toAscii(), fstream::in | fstream::binary);
+    fileHgt.read(header, HGT_CODEC_HEADER_SIZE);
+    fileHgt.close();
+    countIO(HGT_CODEC_HEADER_SIZE, 0, 0, 1);
+
+    if ( ! CHgtCodec::readHeader(header, HGT_CODEC_HEADER_SIZE, &encoding, &x, &y)) return false;
+
+    return (x==sX && y==sY);
+}
+
+void CHgtFile::quantize(int maxError)
+{
+    char *data;
+    qint64 size;
+
+    // heights become what lossy file will hold, encoding them again gives
+    // the same heights, so saveFile stores exactly this data
+    saveMaxError = 0;
+    if (height==0 || maxError<=0) return;
+
+    size = CHgtCodec::encode(height, sizeX, sizeY, HGT_ENCODING_LOSSY, &data, maxError);
+    if (size==0) return;
+
+    if (CHgtCodec::decode(data, size, height, sizeX, sizeY))
+        saveMaxError = maxError;
+    delete []data;
+}
+
+int CHgtFile::countVoids()
+{
+    int i, voids;
+
+    // void is >9000, -32768 of SRTM is 32768 as quint16
+    voids = 0;
+    for (i=0; i<sizeX*sizeY; i++)
+        voids += (height[i]>9000);
+
+    return voids;
+}
+
+int CHgtFile::fillVoids(CHgtFile *source)
+{
+    quint16 *src = source->height;
+    int i, voids;
+    quint16 h;
+
+    // masked select without branches, source must have the same size
+    voids = 0;
+    for (i=0; i<sizeX*sizeY; i++) {
+        h = (height[i]>9000) ? src[i] : height[i];
+        height[i] = h;
+        voids += (h>9000);
+    }
+
+    return voids;
+}
+
 void CHgtFile::getHeightBlock(int *buffer, int x, int y, int sx, int sy, int skip)
 {
     int i;
@@ -185,33 +466,138 @@ void CHgtFile::setHeightBlock(quint16 *buffer, int x, int y, int sx, int sy, int
 
 void CHgtFile::fileOpen(QString name, int sX, int sY)
 {
+    qint64 size;
+    char *data;
+
     sizeX = sX;
     sizeY = sY;
+    fileName = name;
+    fileModified = false;
+    size = QFileInfo(name).size();
     file.open(name.toAscii(), fstream::in | fstream::out | fstream::binary);
+    fileCounters.fileOpens++;
+    if (size==(qint64)sizeX*sizeY*2 || size<HGT_CODEC_HEADER_SIZE) return;
+
+    // encoded file can't be seeked, work on decoded copy until fileClose
+    data = new char[size];
+    file.read(data, size);
+    file.close();
+    fileCounters.bytesRead += size;
+    fileBuffer = new quint16[sizeX*sizeY];
+    if ( ! decodeBuffer(data, size, fileBuffer))
+        cout << "Can't decode " << name.toAscii().data() << endl;
+    delete []data;
 }
 
-void CHgtFile::fileClose()
+void CHgtFile::fileOpen(CHgtArchive *archive, int index, int sX, int sY)
 {
-    file.close();
+    qint64 size;
+    char *data;
+
+    // archived tiles are read only, changes are dropped by fileClose
+    sizeX = sX;
+    sizeY = sY;
+    fileName = "";
+    fileModified = false;
+    size = archive->getLength(index);
+    data = new char[size];
+    fileBuffer = new quint16[sizeX*sizeY];
+    if ( ! archive->readTile(index, data) || ! decodeBuffer(data, size, fileBuffer))
+        cout << "Can't read tile " << index << " from archive" << endl;
+    delete []data;
+    fileCounters.bytesRead += size;
+    fileCounters.seeks++;
+}
+
+void CHgtFile::fileOpenTile(CAvability *avab, QString defaultPath, int sX, int sY)
+{
+    if (avab->archive!=0)
+        fileOpen(avab->archive, avab->archiveIndex, sX, sY); else
+        fileOpen(avab->getFilePath(defaultPath), sX, sY);
+}
+
+bool CHgtFile::fileClose()
+{
+    QFile synced;
+    char *data;
+    qint64 size;
+    bool ok;
+    int i;
+
+    if (fileBuffer==0) {
+        // samples written in place are on disk before tile counts as done
+        file.flush();
+        ok = ! file.fail();
+        file.close();
+        if (ok && fileModified) {
+            synced.setFileName(fileName);
+            ok = synced.open(QIODevice::ReadWrite) && syncFile(&synced);
+            synced.close();
+        }
+        if ( ! ok)
+            cout << "Can't write " << fileName.toAscii().data() << endl;
+        fileModified = false;
+        countIO(fileCounters.bytesRead, fileCounters.bytesWritten, fileCounters.seeks, fileCounters.fileOpens);
+        fileCounters = CHgtFileCounters();
+        return ok;
+    }
+
+    ok = true;
+    if (fileModified && fileName.isEmpty()) {
+        cout << "Archived tile is read only, changes are lost" << endl;
+        ok = false;
+    }
+    if (fileModified && ! fileName.isEmpty()) {
+        size = encodeBuffer(fileBuffer, &data);
+        if (size>0) {
+            ok = writeFileAtomic(fileName, data, size);
+            delete []data;
+        } else {
+            for (i=0; i<sizeX*sizeY; i++)
+                fileBuffer[i] = (fileBuffer[i] >> 8) | (fileBuffer[i] << 8);
+            ok = writeFileAtomic(fileName, (char *)fileBuffer, (qint64)sizeX*sizeY*2);
+        }
+    }
+
+    delete []fileBuffer;
+    fileBuffer = 0;
+    fileModified = false;
+    countIO(fileCounters.bytesRead, fileCounters.bytesWritten, fileCounters.seeks, fileCounters.fileOpens);
+    fileCounters = CHgtFileCounters();
+    return ok;
 }
 
 void CHgtFile::fileSetHeight(int x, int y, int hgt)
 {
     unsigned char byte[2];
 
+    if (fileBuffer!=0) {
+        fileBuffer[y*sizeX + x] = (quint16)hgt;
+        fileModified = true;
+        return;
+    }
+
     byte[0] = (hgt & 0xFF00) >> 8;
     byte[1] = hgt & 0xFF;
 
     file.seekp((y*sizeX + x)*2);
     file.write((char *)byte, 2);
+    fileModified = true;
+    fileCounters.seeks++;
+    fileCounters.bytesWritten += 2;
 }
 
 int CHgtFile::fileGetHeight(int x, int y)
 {
     char byte[2];
 
+    if (fileBuffer!=0)
+        return (int)fileBuffer[y*sizeX + x];
+
     file.seekg((y*sizeX + x)*2);
     file.read(byte, 2);
+    fileCounters.seeks++;
+    fileCounters.bytesRead += 2;
 
     return (int)( (((unsigned char)byte[0]) << 8) + ((unsigned char)byte[1]) );
 }
@@ -39,10 +39,25 @@
 #define CHGTFILE_H
 
 #include <QString>
+#include <QMutex>
 #include <fstream>
 
 using namespace std;
 
+class QFile;
+class CAvability;
+class CHgtArchive;
+
+class CHgtFileCounters
+{
+public:
+    CHgtFileCounters() { bytesRead = 0; bytesWritten = 0; seeks = 0; fileOpens = 0; }
+    qint64 bytesRead;
+    qint64 bytesWritten;
+    qint64 seeks;
+    qint64 fileOpens;
+};
+
 class CHgtFile
 {
 public:
@@ -50,8 +65,16 @@ public:
     ~CHgtFile();
 
     void init(int sX, int sY);
-    void saveFile(QString name);
-    void loadFile(QString name, int x, int y);
+    bool saveFile(QString name);
+    // writes tile only when encoding makes it smaller, for tiles kept raw until
+    // stitched, false only when write failed
+    bool saveFileEncoded(QString name);
+    // tile written raw whatever saveEncoding is, stitching seeks it in place
+    void setSaveRaw(bool raw) { saveRaw = raw; }
+    // rowSkip>1 loads at least rows y%rowSkip==0 for decimating readers
+    void loadFile(QString name, int x, int y, int rowSkip = 1);
+    void loadFile(CHgtArchive *archive, int index, int x, int y, int rowSkip = 1);
+    void loadTile(CAvability *avab, QString defaultPath, int x, int y, int rowSkip = 1);
     int getHeight(int x, int y) { return (int)height[y*sizeX + x]; }
     void setHeight(int x, int y, int hgt) { height[y*sizeX + x] = (quint16)hgt; }
     void getHeightBlock(int *buffer, int x, int y, int sx, int sy, int skip);
@@ -59,7 +82,9 @@ public:
     void setHeightBlock(int *buffer, int x, int y, int sx, int sy, int skip);
     void setHeightBlock(quint16 *buffer, int x, int y, int sx, int sy, int skip);
     void fileOpen(QString name, int sX, int sY);
-    void fileClose();
+    void fileOpen(CHgtArchive *archive, int index, int sX, int sY);
+    void fileOpenTile(CAvability *avab, QString defaultPath, int sX, int sY);
+    bool fileClose();                   // false when changes could not be written
     void fileSetHeight(int x, int y, int hgt);
     int fileGetHeight(int x, int y);
     void fileGetHeightBlock(int *buffer, int x, int y, int sx, int sy, int skip);
@@ -67,14 +92,42 @@ public:
     void fileSetHeightBlock(int *buffer, int x, int y, int sx, int sy, int skip);
     void fileSetHeightBlock(quint16 *buffer, int x, int y, int sx, int sy, int skip);
     void savePGM(QString name);
+    static bool checkFile(QString name, qint64 fileSize, int sX, int sY);
+    static bool writeFileAtomic(QString name, const char *data, qint64 size);     // temp file, fsync, rename
+    static bool replaceFile(QString from, QString to);     // atomic rename over existing file, synced
+    static bool syncFile(QFile *file);
+    void quantize(int maxError);
+    int countVoids();
+    int fillVoids(CHgtFile *source);
+    quint16 *getHeightBuffer() { return height; }
+    int getSizeX() { return sizeX; }
+    int getSizeY() { return sizeY; }
+    void exchangeEndian();
+    static CHgtFileCounters getCounters();      // I/O of all instances since start
+
+    // HGT_ENCODING_* used by saveFile and fileClose, raw (default) keeps plain
+    // HGT files readable by other tools
+    static int saveEncoding;
 
 private:
     fstream file;
     quint16 *height;
     int sizeX;
     int sizeY;
+    QString fileName;
+    quint16 *fileBuffer;
+    bool fileModified;
+    int saveMaxError;           // > 0 saves lossy, set by quantize
+    bool saveRaw;
+    CHgtFileCounters fileCounters;  // file mode I/O, added to totals by fileClose
 
-    void exchangeEndian();
+    static CHgtFileCounters totalCounters;
+    static QMutex countersMutex;
+
+    static void countIO(qint64 bytesRead, qint64 bytesWritten, qint64 seeks, qint64 fileOpens);
+
+    qint64 encodeBuffer(quint16 *buffer, char **data);
+    bool decodeBuffer(const char *data, qint64 size, quint16 *buffer, int rowSkip = 1);
 };
 
 #endif // CHGTFILE_H
@@ -0,0 +1,148 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include "CIndexImagePipeline.h"
+#include "CResizer.h"
+#include "CHgtFile.h"
+#include "CRunReport.h"
+#include "CScopedTimer.h"
+
+CIndexImagePipeline::CIndexImagePipeline(CResizer *r)
+{
+    resizer = r;
+    avab = 0;
+    hgtSourceDegree = 0.0;
+    hgtSourceSize = 0;
+    hgtSource = -1;
+    THsize = 0;
+    thumbnailsOnly = false;
+    threadCount = resizer->threadCount;
+}
+
+void CIndexImagePipeline::createThumbnail(quint16 *buffer, int size, QImage *thumbnail)
+{
+    QImage image(size, size, QImage::Format_RGB32);
+
+    resizer->colorizeImage(buffer, size, size, &image);
+    (*thumbnail) = image.scaledToWidth(THsize, Qt::SmoothTransformation);
+}
+
+bool CIndexImagePipeline::createThumbnailFromL04_L08(int L09_L13_index, QImage *thumbnail)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    quint16 *buffer = new quint16[129*129];
+    double tlLon, tlLat, parentLon, parentLat;
+    int L04_L08_index, offsetX, offsetY;
+    CHgtFile hgtFile;
+
+    // L04-L08 tile covers 4x4 L09-L13 tiles with 1/32 of samples
+    cacheManager->convertAvabilityIndex2TopLeft(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, &tlLon, &tlLat);
+    cacheManager->findTopLeftCorner(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_L04_L08, &parentLon, &parentLat);
+    cacheManager->convertTopLeft2AvabilityIndex(parentLon, parentLat, HGT_SOURCE_DEGREE_SIZE_L04_L08, &L04_L08_index);
+    if ( ! cacheManager->avability_L04_L08[L04_L08_index].available) {
+        delete []buffer;
+        return false;
+    }
+
+    offsetX = (int)( ((tlLon - parentLon) / HGT_SOURCE_DEGREE_SIZE_L09_L13) + 0.5 );
+    offsetY = (int)( ((parentLat - tlLat) / HGT_SOURCE_DEGREE_SIZE_L09_L13) + 0.5 );
+
+    hgtFile.fileOpenTile(&cacheManager->avability_L04_L08[L04_L08_index], cacheManager->pathL04_L08,
+                         HGT_SOURCE_SIZE_L04_L08, HGT_SOURCE_SIZE_L04_L08);
+    hgtFile.fileGetHeightBlock(buffer, offsetX*128, offsetY*128, 129, 129, 1);
+    hgtFile.fileClose();
+    createThumbnail(buffer, 129, thumbnail);
+
+    delete []buffer;
+    return true;
+}
+
+CTilePipelineItem *CIndexImagePipeline::produce(int index)
+{
+    CIndexImageItem *item;
+    CHgtFile hgtFile;
+    double tlLon, tlLat;
+    quint16 *buffer;
+    int skip, size;
+
+    if ( ! avab[index].available)
+        return 0;
+
+    item = new CIndexImageItem();
+    resizer->cacheManager.convertAvabilityIndex2TopLeft(index, hgtSourceDegree, &tlLon, &tlLat);
+    resizer->cacheManager.convertLonLatToFileName(tlLon, tlLat, &item->filename);
+
+    // thumbnail is made from decimated view with at least THsize samples,
+    // full resolution image is never scaled down. Skip divides tile size,
+    // so decimated view ends exactly on last row and column
+    skip = qMax(1, (hgtSourceSize - 1) / THsize);
+    while ((hgtSourceSize - 1) % skip != 0)
+        skip--;
+    size = (hgtSourceSize - 1) / skip + 1;
+    buffer = new quint16[size*size];
+
+    if (thumbnailsOnly) {
+        // full tile is not needed at all - lower LOD or only decimated samples are read
+        if (hgtSource!=HGT_SOURCE_L09_L13 || ! createThumbnailFromL04_L08(index, &item->thumbnail)) {
+            hgtFile.fileOpenTile(&avab[index], pathDir, hgtSourceSize, hgtSourceSize);
+            hgtFile.fileGetHeightBlock(buffer, 0, 0, size, size, skip);
+            hgtFile.fileClose();
+            createThumbnail(buffer, size, &item->thumbnail);
+        }
+    } else {
+        item->image = QImage(hgtSourceSize, hgtSourceSize, QImage::Format_RGB32);
+        hgtFile.loadTile(&avab[index], pathDir, hgtSourceSize, hgtSourceSize);
+        resizer->colorizeImage(&hgtFile, &item->image);
+
+        hgtFile.getHeightBlock(buffer, 0, 0, size, size, skip);
+        createThumbnail(buffer, size, &item->thumbnail);
+    }
+
+    delete []buffer;
+    return item;
+}
+
+void CIndexImagePipeline::consume(CTilePipelineItem *item)
+{
+    CIndexImageItem *imageItem = (CIndexImageItem *)item;
+    CScopedTimer timer("imageEncode");
+
+    if ( ! imageItem->image.isNull())
+        imageItem->image.save(pathDirIndex + imageItem->filename + ".jpg", 0, 90);
+    imageItem->thumbnail.save(pathDirIndex + imageItem->filename + "_th.jpg", 0, 90);
+    CRunReport::getInstance()->count("imagesWritten");
+}
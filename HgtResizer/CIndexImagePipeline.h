@@ -0,0 +1,81 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CINDEXIMAGEPIPELINE_H
+#define CINDEXIMAGEPIPELINE_H
+
+#include <QString>
+#include <QImage>
+#include "CTilePipeline.h"
+#include "CAvability.h"
+
+class CResizer;
+
+class CIndexImageItem : public CTilePipelineItem
+{
+public:
+    QImage image;          // null in thumbnails only mode
+    QImage thumbnail;
+    QString filename;
+};
+
+// images of HTML index: load & color in producers, JPEG encode & thumbnail in consumers
+class CIndexImagePipeline : public CTilePipeline
+{
+public:
+    CResizer *resizer;
+    CAvability *avab;
+    double hgtSourceDegree;
+    int hgtSourceSize;
+    int hgtSource;
+    int THsize;
+    bool thumbnailsOnly;
+    QString pathDir;
+    QString pathDirIndex;
+
+    CIndexImagePipeline(CResizer *r);
+
+protected:
+    CTilePipelineItem *produce(int index);
+    void consume(CTilePipelineItem *item);
+
+private:
+    void createThumbnail(quint16 *buffer, int size, QImage *thumbnail);
+    bool createThumbnailFromL04_L08(int L09_L13_index, QImage *thumbnail);
+};
+
+#endif // CINDEXIMAGEPIPELINE_H
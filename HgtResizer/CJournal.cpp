@@ -0,0 +1,169 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QTextStream>
+#include <QFileInfo>
+#include <QStringList>
+#include "CJournal.h"
+#include "CHgtFile.h"
+#include "CLog.h"
+
+CJournal::CJournal()
+{
+}
+
+CJournal::~CJournal()
+{
+    close();
+}
+
+QString CJournal::getKey(const QString &task, int hgtSource, int index)
+{
+    return task + " " + QString::number(hgtSource) + " " + QString::number(index);
+}
+
+bool CJournal::open(const QString &name)
+{
+    QString line;
+    QStringList fields;
+    CJournalEntry entry;
+    bool ok[2];
+    bool terminated = true;
+
+    close();
+    entries.clear();
+    file.setFileName(name);
+
+    // last line can be torn by crash, it is ignored
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while ( ! in.atEnd()) {
+            line = in.readLine();
+            fields = line.split(' ', QString::SkipEmptyParts);
+            if (fields.size()!=5) continue;
+            entry.size = fields.at(3).toLongLong(&ok[0]);
+            entry.hash = fields.at(4).toULongLong(&ok[1], 16);
+            if (ok[0] && ok[1] && fields.at(4).length()==16)
+                entries.insert(getKey(fields.at(0), fields.at(1).toInt(), fields.at(2).toInt()), entry);
+        }
+        // torn line has no newline, next record would be glued to it
+        if (file.size()>0 && file.seek(file.size() - 1))
+            terminated = (file.read(1)=="\n");
+        file.close();
+    }
+
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return false;
+    if ( ! terminated) {
+        file.write("\n");
+        file.flush();
+    }
+
+    return true;
+}
+
+void CJournal::close()
+{
+    if (file.isOpen())
+        file.close();
+}
+
+bool CJournal::isDone(const QString &task, int hgtSource, int index, const QString &outputName, bool checkSize)
+{
+    QMutexLocker locker(&mutex);
+    QString key = getKey(task, hgtSource, index);
+    QFileInfo info(outputName);
+    qint64 size;
+
+    if ( ! entries.contains(key)) return false;
+
+    // output could be replaced or truncated after it was journaled
+    if ( ! info.exists() || (checkSize && info.size()!=entries.value(key).size)) {
+        LOG_WARNING << "Journaled output" << outputName << "is missing or has wrong size, rebuilding";
+        return false;
+    }
+    // same size but torn or rewritten content
+    if (checkSize && hashFile(outputName, &size)!=entries.value(key).hash) {
+        LOG_WARNING << "Journaled output" << outputName << "has wrong hash, rebuilding";
+        return false;
+    }
+
+    return true;
+}
+
+quint64 CJournal::hashFile(const QString &name, qint64 *size)
+{
+    QFile in(name);
+    QByteArray data;
+    quint64 hash = 14695981039346656037ULL;
+    const uchar *p;
+    int i;
+
+    (*size) = 0;
+    if ( ! in.open(QIODevice::ReadOnly)) return hash;
+    data = in.readAll();
+    in.close();
+
+    p = (const uchar *)data.constData();
+    for (i=0; i<data.size(); i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    (*size) = data.size();
+
+    return hash;
+}
+
+void CJournal::record(const QString &task, int hgtSource, int index, const QString &outputName)
+{
+    CJournalEntry entry;
+
+    if ( ! file.isOpen()) return;
+
+    // tiles without output (no input data) are not journaled, they are cheap to skip again
+    if ( ! QFileInfo(outputName).exists()) return;
+    entry.hash = hashFile(outputName, &entry.size);
+
+    QMutexLocker locker(&mutex);
+    entries.insert(getKey(task, hgtSource, index), entry);
+
+    QTextStream out(&file);
+    out << getKey(task, hgtSource, index) << " " << entry.size << " "
+        << QString::number(entry.hash, 16).rightJustified(16, '0') << "\n";
+    out.flush();
+    if ( ! CHgtFile::syncFile(&file))
+        LOG_ERROR << "Can't sync journal" << file.fileName();
+}
@@ -0,0 +1,85 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CJOURNAL_H
+#define CJOURNAL_H
+
+#include <QString>
+#include <QMap>
+#include <QFile>
+#include <QMutex>
+
+#define JOURNAL_FILENAME          "journal.txt"
+
+class CJournalEntry
+{
+public:
+    qint64 size;
+    quint64 hash;          // FNV-1a of output file
+};
+
+// Append-only record of finished tiles, line per tile:
+//   <task> <hgtSource> <index> <output size> <output hash>
+// Line is written after output was synced to disk, so journaled tile is
+// complete. Resumed run skips tiles whose output still has journaled size
+// and hash.
+// Tiles can be recorded from several threads.
+class CJournal
+{
+public:
+    CJournal();
+    ~CJournal();
+
+    bool open(const QString &name);
+    void close();
+    // checkSize compares size and hash of output with journal, stitching
+    // changes neighbors later, checkSize=false for it
+    bool isDone(const QString &task, int hgtSource, int index, const QString &outputName, bool checkSize = true);
+    void record(const QString &task, int hgtSource, int index, const QString &outputName);
+    int getCount() { return entries.size(); }
+
+    static quint64 hashFile(const QString &name, qint64 *size);
+
+private:
+    QFile file;
+    QMap<QString, CJournalEntry> entries;
+    QMutex mutex;
+
+    static QString getKey(const QString &task, int hgtSource, int index);
+};
+
+#endif // CJOURNAL_H
@@ -0,0 +1,333 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <math.h>
+#include <QFile>
+#include <QDataStream>
+#include "CLodData.h"
+#include "CHgtFile.h"
+#include "CReliefRenderer.h"
+
+#define LOD_DATA_PI             3.14159265358979323846
+#define LOD_DATA_METERS_DEGREE  111320.0
+
+CLodData::CLodData()
+{
+    int i;
+
+    hgtSource = -1;
+    firstLOD = 0;
+    LODcount = 0;
+    for (i=0; i<14; i++) {
+        normal[i] = 0;
+        error[i] = 0;
+        vertexCount[i] = 0;
+        chunkCount[i] = 0;
+    }
+}
+
+CLodData::~CLodData()
+{
+    clear();
+}
+
+void CLodData::clear()
+{
+    int i;
+
+    for (i=0; i<14; i++) {
+        if (normal[i]!=0)
+            delete []normal[i];
+        if (error[i]!=0)
+            delete []error[i];
+        normal[i] = 0;
+        error[i] = 0;
+        vertexCount[i] = 0;
+        chunkCount[i] = 0;
+    }
+}
+
+void CLodData::init(int hgtSrc)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    int lod, size, i;
+
+    clear();
+    hgtSource = hgtSrc;
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: firstLOD = 0; LODcount = 4; break;
+        case HGT_SOURCE_L04_L08: firstLOD = 4; LODcount = 5; break;
+        case HGT_SOURCE_L09_L13: firstLOD = 9; LODcount = 5; break;
+    }
+
+    size = cacheManager->HGTsourceSizeLookUp[firstLOD];
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        vertexCount[lod] = (size - 1) / cacheManager->HGTsourceSkippingLookUp[lod] + 1;
+        chunkCount[lod] = (vertexCount[lod] - 1) / 8;
+        normal[lod] = new uchar[2 * vertexCount[lod] * vertexCount[lod]];
+        error[lod] = new quint16[chunkCount[lod] * chunkCount[lod]];
+        for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+            error[lod][i] = 0;
+    }
+}
+
+QString CLodData::getFileName(const QString &hgtFilename)
+{
+    return hgtFilename.left(hgtFilename.length() - 4) + ".lod";
+}
+
+void CLodData::encodeNormals(const float *p, const float *q, int n, uchar *packed)
+{
+    float nx, ny, l1;
+    int i;
+
+    // normal (-p, -q, 1) points up, so octahedron projection needs no folding
+    for (i=0; i<n; i++) {
+        l1 = 1.0f / (fabsf(p[i]) + fabsf(q[i]) + 1.0f);
+        nx = -p[i] * l1;
+        ny = -q[i] * l1;
+        packed[2*i]   = (uchar)((nx * 0.5f + 0.5f) * 254.0f + 0.5f);
+        packed[2*i+1] = (uchar)((ny * 0.5f + 0.5f) * 254.0f + 0.5f);
+    }
+}
+
+void CLodData::decodeNormal(const uchar *packed, float *nx, float *ny, float *nz)
+{
+    float x = packed[0] / 254.0f * 2.0f - 1.0f;
+    float y = packed[1] / 254.0f * 2.0f - 1.0f;
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    float t, len;
+
+    if (z<0.0f) {
+        t = x;
+        x = (x>=0.0f ? 1.0f : -1.0f) * (1.0f - fabsf(y));
+        y = (y>=0.0f ? 1.0f : -1.0f) * (1.0f - fabsf(t));
+    }
+    len = sqrtf(x*x + y*y + z*z);
+    (*nx) = x / len;
+    (*ny) = y / len;
+    (*nz) = z / len;
+}
+
+void CLodData::getNormal(int lod, int x, int y, float *nx, float *ny, float *nz)
+{
+    decodeNormal(&normal[lod][2*(y*vertexCount[lod] + x)], nx, ny, nz);
+}
+
+void CLodData::compute(CHgtFile *hgt, double tlLat)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    double degreeSize = cacheManager->HGTsourceDegreeSizeLookUp[firstLOD];
+    quint16 *height = hgt->getHeightBuffer();
+    int size = hgt->getSizeX();
+    float *rows, *p, *q;
+    float dx, dy;
+    double lat;
+    int lod, n, skip, x, y, r, sy, h;
+
+    // normals of LOD grid, dx/dy are LOD vertex spacing
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        n = vertexCount[lod];
+        skip = cacheManager->HGTsourceSkippingLookUp[lod];
+        rows = new float[3*(n+2)];
+        p = new float[n];
+        q = new float[n];
+
+        dy = (float)( degreeSize / (n - 1) * LOD_DATA_METERS_DEGREE );
+        for (y=0; y<n; y++) {
+            // rows y-1, y, y+1 with edge replicated, voids as sea level
+            for (r=0; r<3; r++) {
+                sy = qMax(0, qMin(y + r - 1, n - 1)) * skip;
+                for (x=0; x<n; x++) {
+                    h = height[sy*size + x*skip];
+                    rows[r*(n+2) + x+1] = (h>9000) ? 0.0f : (float)h;
+                }
+                rows[r*(n+2)] = rows[r*(n+2) + 1];
+                rows[r*(n+2) + n+1] = rows[r*(n+2) + n];
+            }
+
+            lat = tlLat - y * degreeSize / (n - 1);
+            dx = dy * (float)qMax(cos(lat * (LOD_DATA_PI / 180.0)), 0.01);
+            CReliefRenderer::hornRow(&rows[0], &rows[n+2], &rows[2*(n+2)], n, dx, dy, p, q);
+            encodeNormals(p, q, n, &normal[lod][2*y*n]);
+        }
+
+        delete []rows;
+        delete []p;
+        delete []q;
+    }
+
+    // errors between LODs inside tile, finer LOD has half of skipping
+    for (lod=firstLOD; lod<firstLOD+LODcount-1; lod++)
+        accumulateError(lod, hgt, cacheManager->HGTsourceSkippingLookUp[lod] / 2, 0, 0, chunkCount[lod]);
+}
+
+void CLodData::accumulateError(int lod, CHgtFile *fine, int fineSkip, int chunkX0, int chunkY0, int chunks)
+{
+    quint16 *height = fine->getHeightBuffer();
+    int size = fine->getSizeX();
+    int n = chunks*16 + 1;          // chunk has 8 coarse = 16 fine cells
+    float *above, *row, *below, *rowError, *swap;
+    int x, y, cx, cy, h, i;
+    float e, maxError;
+
+    above = new float[n];
+    row = new float[n];
+    below = new float[n];
+    rowError = new float[n];
+
+    for (y=0; y<n; y++) {
+        for (x=0; x<n; x++) {
+            h = height[(y*fineSkip)*size + x*fineSkip];
+            row[x] = (h>9000) ? 0.0f : (float)h;
+        }
+
+        // coarse surface is bilinear between even samples
+        if (y%2==0) {
+            for (x=0; x<n; x++)
+                rowError[x] = 0.0f;
+            for (x=1; x<n-1; x+=2)
+                rowError[x] = fabsf(row[x] - 0.5f*(row[x-1] + row[x+1]));
+        } else {
+            // below is read now, it becomes above of next odd row
+            for (x=0; x<n; x++) {
+                h = height[((y+1)*fineSkip)*size + x*fineSkip];
+                below[x] = (h>9000) ? 0.0f : (float)h;
+            }
+            for (x=0; x<n; x+=2)
+                rowError[x] = fabsf(row[x] - 0.5f*(above[x] + below[x]));
+            for (x=1; x<n-1; x+=2)
+                rowError[x] = fabsf(row[x] - 0.25f*(above[x-1] + above[x+1] + below[x-1] + below[x+1]));
+        }
+
+        // odd rows are inside one chunk row, even rows are on borders
+        if (y%2==1) {
+            cy = chunkY0 + y/16;
+            for (cx=0; cx<chunks; cx++) {
+                maxError = 0.0f;
+                for (i=cx*16; i<=cx*16+16; i++)
+                    maxError = qMax(maxError, rowError[i]);
+                e = ceilf(maxError);
+                i = cy*chunkCount[lod] + chunkX0 + cx;
+                if (e > error[lod][i])
+                    error[lod][i] = (quint16)qMin(e, 65535.0f);
+            }
+        } else {
+            for (cy=y/16-1; cy<=y/16; cy++) {
+                if (cy<0 || cy>=chunks || (y%16!=0 && cy!=y/16)) continue;
+                for (cx=0; cx<chunks; cx++) {
+                    maxError = 0.0f;
+                    for (i=cx*16; i<=cx*16+16; i++)
+                        maxError = qMax(maxError, rowError[i]);
+                    e = ceilf(maxError);
+                    i = (chunkY0 + cy)*chunkCount[lod] + chunkX0 + cx;
+                    if (e > error[lod][i])
+                        error[lod][i] = (quint16)qMin(e, 65535.0f);
+                }
+            }
+        }
+
+        if (y%2==0) {
+            swap = above; above = row; row = swap;
+        }
+    }
+
+    delete []above;
+    delete []row;
+    delete []below;
+    delete []rowError;
+}
+
+void CLodData::addQuantizationError(int maxError)
+{
+    int lod = firstLOD + LODcount - 1;
+    int i;
+
+    if (maxError<=0) return;
+    for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+        error[lod][i] = (quint16)qMin((int)error[lod][i] + maxError, 65535);
+}
+
+bool CLodData::saveFile(QString name)
+{
+    QByteArray data;
+    int lod, i;
+
+    if (LODcount==0) return false;
+
+    // big endian, same as HGT files; normals are bytes; torn file never
+    // replaces complete one
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (quint32)LOD_DATA_MAGIC << (quint16)LOD_DATA_VERSION
+        << (quint16)hgtSource << (quint16)firstLOD << (quint16)LODcount;
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        out << (quint16)vertexCount[lod] << (quint16)chunkCount[lod];
+        for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+            out << error[lod][i];
+        out.writeRawData((const char *)normal[lod], 2 * vertexCount[lod] * vertexCount[lod]);
+    }
+
+    return CHgtFile::writeFileAtomic(name, data.constData(), data.size());
+}
+
+bool CLodData::loadFile(QString name)
+{
+    QFile file(name);
+    quint32 magic;
+    quint16 version, src, first, count, vertices, chunks;
+    int lod, i;
+
+    if ( ! file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in >> magic >> version >> src >> first >> count;
+    if (magic!=LOD_DATA_MAGIC || version!=LOD_DATA_VERSION) {
+        file.close();
+        return false;
+    }
+
+    init(src);
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        in >> vertices >> chunks;
+        for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+            in >> error[lod][i];
+        in.readRawData((char *)normal[lod], 2 * vertexCount[lod] * vertexCount[lod]);
+    }
+    file.close();
+
+    return (in.status()==QDataStream::Ok);
+}
@@ -0,0 +1,90 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CLODDATA_H
+#define CLODDATA_H
+
+#include <QString>
+#include "CCacheManager.h"
+#include "CHgtFile.h"
+
+#define LOD_DATA_MAGIC            0x4847544C      // 'HGTL'
+#define LOD_DATA_VERSION          1
+
+// Precomputed data for chunked LOD rendering of one tile:
+//  - normal map of every LOD, one normal per LOD vertex (LOD grid is tile
+//    sampled with HGTsourceSkippingLookUp), octahedral encoded to 2 bytes (0..254, 127 = 0)
+//  - maximal vertical error [m] of every chunk against next finer LOD, i.e.
+//    how far interpolated coarse surface is from samples the finer LOD adds.
+//    Finest LOD of L00-L03 and L04-L08 is compared with the next source
+//    level (see accumulateError), finest LOD of L09-L13 has zero error.
+class CLodData
+{
+public:
+    int hgtSource;
+    int firstLOD;
+    int LODcount;
+
+    CLodData();
+    ~CLodData();
+
+    void init(int hgtSrc);
+    void compute(CHgtFile *hgt, double tlLat);
+    void accumulateError(int lod, CHgtFile *fine, int fineSkip, int chunkX0, int chunkY0, int chunks);
+    // finest LOD vertices moved up to maxError [m] by lossy encoding, after
+    // accumulateError against next source level
+    void addQuantizationError(int maxError);
+    bool saveFile(QString name);
+    bool loadFile(QString name);
+    int getVertexCount(int lod) { return vertexCount[lod]; }
+    int getChunkCount(int lod) { return chunkCount[lod]; }
+    void getNormal(int lod, int x, int y, float *nx, float *ny, float *nz);
+    int getError(int lod, int cx, int cy) { return error[lod][cy*chunkCount[lod] + cx]; }
+    static QString getFileName(const QString &hgtFilename);
+    static void encodeNormals(const float *p, const float *q, int n, uchar *packed);
+    static void decodeNormal(const uchar *packed, float *nx, float *ny, float *nz);
+
+private:
+    uchar *normal[14];         // 2 bytes per vertex, row-major
+    quint16 *error[14];        // one per chunk, row-major
+    int vertexCount[14];       // vertices per tile side in each LOD
+    int chunkCount[14];        // chunks per tile side in each LOD
+
+    void clear();
+};
+
+#endif // CLODDATA_H
@@ -0,0 +1,63 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CLOG_H
+#define CLOG_H
+
+#include <QDebug>
+
+#define LOG_LEVEL_ERROR           0
+#define LOG_LEVEL_WARNING         1
+#define LOG_LEVEL_INFO            2
+#define LOG_LEVEL_DEBUG           3
+
+// Stream is not evaluated at all when level is disabled, so arguments cost
+// nothing, e.g. LOG_DEBUG << "sample" << x << y; single statement, safe in if-else
+#define LOG_ERROR    for (bool logOnce = CLog::isEnabled(LOG_LEVEL_ERROR); logOnce; logOnce = false) qCritical()
+#define LOG_WARNING  for (bool logOnce = CLog::isEnabled(LOG_LEVEL_WARNING); logOnce; logOnce = false) qWarning()
+#define LOG_INFO     for (bool logOnce = CLog::isEnabled(LOG_LEVEL_INFO); logOnce; logOnce = false) qDebug()
+#define LOG_DEBUG    for (bool logOnce = CLog::isEnabled(LOG_LEVEL_DEBUG); logOnce; logOnce = false) qDebug()
+
+class CLog
+{
+public:
+    static int level;          // LOG_LEVEL_*, messages above it are dropped
+
+    static bool isEnabled(int l) { return l<=level; }
+};
+
+#endif // CLOG_H
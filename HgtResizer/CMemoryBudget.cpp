@@ -0,0 +1,136 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <QtGlobal>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#endif
+#include "CMemoryBudget.h"
+#include "CCacheManager.h"
+#include "CRunReport.h"
+#include "CTrace.h"
+
+CMemoryBudget CMemoryBudget::instance;
+
+CMemoryBudget::CMemoryBudget()
+{
+    limit = 0;
+    used = 0;
+    peakUsed = 0;
+}
+
+CMemoryBudget *CMemoryBudget::getInstance()
+{
+    return &instance;
+}
+
+void CMemoryBudget::setLimit(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    limit = bytes;
+    released.wakeAll();
+}
+
+void CMemoryBudget::acquire(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+
+    if (limit>0 && used>0 && used+bytes>limit) {
+        CRunReport::getInstance()->count("jobsWaitedForMemory");
+        CTrace::begin("waitMemory");
+        while (used>0 && used+bytes>limit)
+            released.wait(&mutex);
+        CTrace::end("waitMemory");
+    }
+    used += bytes;
+    peakUsed = qMax(peakUsed, used);
+}
+
+void CMemoryBudget::release(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    used -= bytes;
+    released.wakeAll();
+}
+
+qint64 CMemoryBudget::getBuildJobMemory(int hgtSource)
+{
+    return (hgtSource==HGT_SOURCE_L09_L13) ? MEMORY_JOB_BUILD_L09_L13 : MEMORY_JOB_DECIMATE;
+}
+
+qint64 CMemoryBudget::readProcStatus(const char *key)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t length = strlen(key);
+
+    // e.g. "VmRSS:     123456 kB"
+    while (std::getline(status, line))
+        if (line.compare(0, length, key)==0)
+            return atoll(line.c_str() + length) * 1024;
+
+    return 0;
+}
+
+qint64 CMemoryBudget::getRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if ( ! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#else
+    return readProcStatus("VmRSS:");
+#endif
+}
+
+qint64 CMemoryBudget::getPeakRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if ( ! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    return readProcStatus("VmHWM:");
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CMEMORYBUDGET_H
+#define CMEMORYBUDGET_H
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#define MEMORY_MB                       (1024LL*1024LL)
+// peak memory of single job, measured on full tiles
+#define MEMORY_JOB_BUILD_L09_L13        (500*MEMORY_MB)     // 4501^2 copy, void filling, resampling
+#define MEMORY_JOB_DECIMATE              (35*MEMORY_MB)     // L04_L08 and L00_L03 builds
+#define MEMORY_JOB_CONNECT              (320*MEMORY_MB)     // tile and 8 neighbors
+#define MEMORY_JOB_SIDECARS             (100*MEMORY_MB)     // L09_L13 tile, LOD normals, min/max tree
+#define MEMORY_JOB_INDEX_IMAGE_SAMPLE     6                 // [B] height and RGB32 pixel, ~100 MB for L09_L13
+#define MEMORY_JOB_RELIEF_SAMPLE         17                 // [B] float grid, gradients, shade and 3 images
+
+// Admission of jobs by their estimated memory. acquire() blocks until job
+// fits into limit together with jobs already running, so many small jobs
+// run in parallel while large ones are serialized. Job larger than limit
+// is admitted alone. Limit 0 = unlimited, only peak is tracked.
+class CMemoryBudget
+{
+public:
+    static CMemoryBudget *getInstance();
+
+    void setLimit(qint64 bytes);
+    qint64 getLimit() { return limit; }
+    void acquire(qint64 bytes);
+    void release(qint64 bytes);
+    qint64 getPeakUsed() { return peakUsed; }
+
+    static qint64 getBuildJobMemory(int hgtSource);
+    static qint64 getRss();                 // resident set size of process, 0 if unknown
+    static qint64 getPeakRss();             // high water mark of process
+
+private:
+    CMemoryBudget();
+
+    static CMemoryBudget instance;
+    QMutex mutex;
+    QWaitCondition released;
+    qint64 limit;
+    qint64 used;
+    qint64 peakUsed;
+
+    static qint64 readProcStatus(const char *key);
+};
+
+#endif // CMEMORYBUDGET_H
@@ -0,0 +1,258 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include <QDataStream>
+#include "CMinMaxTree.h"
+#include "CHgtFile.h"
+
+CMinMaxTree::CMinMaxTree()
+{
+    nodeMin = 0;
+    nodeMax = 0;
+    levelCount = 0;
+    tileSize = 0;
+}
+
+CMinMaxTree::~CMinMaxTree()
+{
+    clear();
+}
+
+void CMinMaxTree::clear()
+{
+    if (nodeMin!=0)
+        delete []nodeMin;
+    if (nodeMax!=0)
+        delete []nodeMax;
+    nodeMin = 0;
+    nodeMax = 0;
+    levelCount = 0;
+}
+
+void CMinMaxTree::allocate(int size)
+{
+    int leaves;
+
+    clear();
+    tileSize = size;
+    leaves = (size - 1) / MINMAX_TREE_LEAF_CELLS;
+    levelCount = 1;
+    while ((1 << (levelCount-1)) < leaves)
+        levelCount++;
+
+    nodeMin = new quint16[getLevelOffset(levelCount)];
+    nodeMax = new quint16[getLevelOffset(levelCount)];
+}
+
+QString CMinMaxTree::getFileName(const QString &hgtFilename)
+{
+    return hgtFilename.left(hgtFilename.length() - 4) + ".mmt";
+}
+
+void CMinMaxTree::build(CHgtFile *hgt)
+{
+    int leaves, level, offset, parentOffset, count;
+    int x, y, lx, ly, h, v, i, c;
+    int *rowMin, *rowMax;
+    quint16 *row;
+
+    allocate(hgt->getSizeX());
+    leaves = 1 << (levelCount-1);
+    offset = getLevelOffset(levelCount-1);
+    rowMin = new int[leaves];
+    rowMax = new int[leaves];
+
+    for (i=0; i<leaves*leaves; i++) {
+        nodeMin[offset + i] = 65535;
+        nodeMax[offset + i] = 0;
+    }
+
+    // leaves - one pass over tile, row by row
+    for (y=0; y<tileSize; y++) {
+        row = hgt->getHeightBuffer() + y*tileSize;
+
+        for (lx=0; lx<leaves; lx++) {
+            rowMin[lx] = 65535;
+            rowMax[lx] = 0;
+            for (x=lx*MINMAX_TREE_LEAF_CELLS; x<=lx*MINMAX_TREE_LEAF_CELLS+MINMAX_TREE_LEAF_CELLS; x++) {
+                h = row[x];
+                v = (h>9000);
+                rowMin[lx] = qMin(rowMin[lx], v ? 65535 : h);
+                rowMax[lx] = qMax(rowMax[lx], v ? 0 : h);
+            }
+        }
+
+        // row belongs to leaf row y/8, border rows also to previous one
+        for (i=0; i<2; i++) {
+            ly = y/MINMAX_TREE_LEAF_CELLS - i;
+            if (ly<0 || ly>=leaves) continue;
+            if (i==1 && y%MINMAX_TREE_LEAF_CELLS!=0) continue;
+
+            for (lx=0; lx<leaves; lx++) {
+                c = offset + ly*leaves + lx;
+                nodeMin[c] = (quint16)qMin((int)nodeMin[c], rowMin[lx]);
+                nodeMax[c] = (quint16)qMax((int)nodeMax[c], rowMax[lx]);
+            }
+        }
+    }
+
+    // inner nodes from 2x2 children
+    for (level=levelCount-2; level>=0; level--) {
+        count = 1 << level;
+        parentOffset = getLevelOffset(level);
+        offset = getLevelOffset(level+1);
+        for (y=0; y<count; y++)
+            for (x=0; x<count; x++) {
+                c = offset + (2*y)*(2*count) + 2*x;
+                nodeMin[parentOffset + y*count + x] = qMin(qMin(nodeMin[c], nodeMin[c+1]),
+                                                           qMin(nodeMin[c+2*count], nodeMin[c+2*count+1]));
+                nodeMax[parentOffset + y*count + x] = qMax(qMax(nodeMax[c], nodeMax[c+1]),
+                                                           qMax(nodeMax[c+2*count], nodeMax[c+2*count+1]));
+            }
+    }
+
+    delete []rowMin;
+    delete []rowMax;
+}
+
+void CMinMaxTree::getNode(int level, int nx, int ny, int *min, int *max)
+{
+    int c = getLevelOffset(level) + ny*(1 << level) + nx;
+
+    (*min) = nodeMin[c];
+    (*max) = nodeMax[c];
+}
+
+void CMinMaxTree::getRange(int x0, int y0, int x1, int y1, int *min, int *max, CHgtFile *hgt)
+{
+    // closed sample rectangle [x0, x1] x [y0, y1]. Without hgt partially covered
+    // leaves are taken as a whole, so range is conservative (may be wider)
+    (*min) = 65535;
+    (*max) = 0;
+    if (levelCount==0) return;
+
+    getRangeNode(0, 0, 0, qMax(x0, 0), qMax(y0, 0), qMin(x1, tileSize-1), qMin(y1, tileSize-1), min, max, hgt);
+}
+
+void CMinMaxTree::getRangeNode(int level, int nx, int ny, int x0, int y0, int x1, int y1, int *min, int *max, CHgtFile *hgt)
+{
+    int cells = (tileSize - 1) >> level;
+    int nodeX0 = nx*cells, nodeY0 = ny*cells;
+    int nodeX1 = nodeX0 + cells, nodeY1 = nodeY0 + cells;
+    int c = getLevelOffset(level) + ny*(1 << level) + nx;
+    int x, y, h;
+
+    // no intersection or nothing interesting inside
+    if (nodeX1<x0 || nodeX0>x1 || nodeY1<y0 || nodeY0>y1) return;
+    if (nodeMin[c]>=(*min) && nodeMax[c]<=(*max)) return;
+
+    // node inside rectangle
+    if (nodeX0>=x0 && nodeX1<=x1 && nodeY0>=y0 && nodeY1<=y1) {
+        (*min) = qMin((*min), (int)nodeMin[c]);
+        (*max) = qMax((*max), (int)nodeMax[c]);
+        return;
+    }
+
+    // partially covered leaf
+    if (level==levelCount-1) {
+        if (hgt==0) {
+            (*min) = qMin((*min), (int)nodeMin[c]);
+            (*max) = qMax((*max), (int)nodeMax[c]);
+        } else {
+            for (y=qMax(nodeY0, y0); y<=qMin(nodeY1, y1); y++)
+                for (x=qMax(nodeX0, x0); x<=qMin(nodeX1, x1); x++) {
+                    h = hgt->getHeight(x, y);
+                    if (h>9000) continue;
+                    (*min) = qMin((*min), h);
+                    (*max) = qMax((*max), h);
+                }
+        }
+        return;
+    }
+
+    getRangeNode(level+1, 2*nx,   2*ny,   x0, y0, x1, y1, min, max, hgt);
+    getRangeNode(level+1, 2*nx+1, 2*ny,   x0, y0, x1, y1, min, max, hgt);
+    getRangeNode(level+1, 2*nx,   2*ny+1, x0, y0, x1, y1, min, max, hgt);
+    getRangeNode(level+1, 2*nx+1, 2*ny+1, x0, y0, x1, y1, min, max, hgt);
+}
+
+bool CMinMaxTree::saveFile(QString name)
+{
+    QByteArray data;
+    int i;
+
+    if (levelCount==0) return false;
+
+    // big endian, same as HGT files; torn file never replaces complete one
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (quint32)MINMAX_TREE_MAGIC << (quint16)MINMAX_TREE_VERSION
+        << (quint16)tileSize << (quint16)levelCount;
+    for (i=0; i<getLevelOffset(levelCount); i++)
+        out << nodeMin[i] << nodeMax[i];
+
+    return CHgtFile::writeFileAtomic(name, data.constData(), data.size());
+}
+
+bool CMinMaxTree::loadFile(QString name)
+{
+    QFile file(name);
+    quint32 magic;
+    quint16 version, size, levels;
+    int i;
+
+    if ( ! file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in >> magic >> version >> size >> levels;
+    if (magic!=MINMAX_TREE_MAGIC || version!=MINMAX_TREE_VERSION) {
+        file.close();
+        return false;
+    }
+
+    allocate(size);
+    if (levels!=levelCount) {
+        clear();
+        file.close();
+        return false;
+    }
+    for (i=0; i<getLevelOffset(levelCount); i++)
+        in >> nodeMin[i] >> nodeMax[i];
+    file.close();
+
+    return (in.status()==QDataStream::Ok);
+}
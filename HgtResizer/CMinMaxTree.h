@@ -0,0 +1,79 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CMINMAXTREE_H
+#define CMINMAXTREE_H
+
+#include <QString>
+#include "CHgtFile.h"
+
+#define MINMAX_TREE_MAGIC         0x4847544D      // 'HGTM'
+#define MINMAX_TREE_VERSION       1
+#define MINMAX_TREE_LEAF_CELLS    8               // leaf = one chunk of finest LOD
+
+// Implicit min/max quadtree of one tile. Level 0 is the root, last level
+// holds leaves of MINMAX_TREE_LEAF_CELLS x MINMAX_TREE_LEAF_CELLS cells.
+// Node covers closed block of samples (shared borders included). Voids are
+// skipped, node with voids only has min=65535 and max=0.
+class CMinMaxTree
+{
+public:
+    CMinMaxTree();
+    ~CMinMaxTree();
+
+    void build(CHgtFile *hgt);
+    bool saveFile(QString name);
+    bool loadFile(QString name);
+    int getLevelCount() { return levelCount; }
+    int getTileSize() { return tileSize; }
+    void getNode(int level, int nx, int ny, int *min, int *max);
+    void getRange(int x0, int y0, int x1, int y1, int *min, int *max, CHgtFile *hgt = 0);
+    static QString getFileName(const QString &hgtFilename);
+
+private:
+    quint16 *nodeMin;
+    quint16 *nodeMax;
+    int levelCount;
+    int tileSize;
+
+    int getLevelOffset(int level) { return ((1 << (2*level)) - 1) / 3; }
+    void clear();
+    void allocate(int size);
+    void getRangeNode(int level, int nx, int ny, int x0, int y0, int x1, int y1, int *min, int *max, CHgtFile *hgt);
+};
+
+#endif // CMINMAXTREE_H
@@ -0,0 +1,290 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <math.h>
+#include <QDebug>
+#include "CReliefRenderer.h"
+#include "CResizer.h"
+#include "CHgtFile.h"
+#include "CRunReport.h"
+#include "CScopedTimer.h"
+#include "CMemoryBudget.h"
+
+#define RELIEF_PI             3.14159265358979323846
+#define RELIEF_METERS_DEGREE  111320.0
+
+CReliefRenderer::CReliefRenderer(CResizer *r)
+{
+    int i;
+
+    resizer = r;
+    azimuth = 315.0;
+    altitude = 45.0;
+    zFactor = 1.0;
+    avab = 0;
+    hgtSource = -1;
+    hgtSourceSize = 0;
+    hgtSourceDegree = 0.0;
+    tilesX = 0;
+    tilesY = 0;
+    threadCount = resizer->threadCount;
+    // three rows of tiles around the ones in flight
+    tileCache = new CTileCache(3*(threadCount + 2));
+
+    for (i=0; i<256; i++)
+        grayTable.append(qRgb(i, i, i));
+}
+
+CReliefRenderer::~CReliefRenderer()
+{
+    delete tileCache;
+}
+
+void CReliefRenderer::hornRow(const float *north, const float *middle, const float *south, int n,
+                              float dx, float dy, float *p, float *q)
+{
+    float kx = 1.0f / (8.0f * dx);
+    float ky = 1.0f / (8.0f * dy);
+    int i;
+
+    //  a b c      p = ((c + 2f + i) - (a + 2d + g)) / 8dx
+    //  d e f      q = ((a + 2b + c) - (g + 2h + i)) / 8dy
+    //  g h i
+    for (i=0; i<n; i++) {
+        p[i] = ( (north[i+2] + 2.0f*middle[i+2] + south[i+2]) - (north[i] + 2.0f*middle[i] + south[i]) ) * kx;
+        q[i] = ( (north[i] + 2.0f*north[i+1] + north[i+2]) - (south[i] + 2.0f*south[i+1] + south[i+2]) ) * ky;
+    }
+}
+
+void CReliefRenderer::shadeRow(const float *p, const float *q, int n, double azimuth, double altitude, float *shade)
+{
+    float lx = (float)( sin(azimuth * (RELIEF_PI / 180.0)) * cos(altitude * (RELIEF_PI / 180.0)) );
+    float ly = (float)( cos(azimuth * (RELIEF_PI / 180.0)) * cos(altitude * (RELIEF_PI / 180.0)) );
+    float lz = (float)sin(altitude * (RELIEF_PI / 180.0));
+    float s;
+    int i;
+
+    // surface normal (-p, -q, 1) dot light vector
+    for (i=0; i<n; i++) {
+        s = (lz - p[i]*lx - q[i]*ly) / sqrtf(1.0f + p[i]*p[i] + q[i]*q[i]);
+        shade[i] = (s>0.0f) ? s : 0.0f;
+    }
+}
+
+bool CReliefRenderer::readNeighbour(int index, int dx, int dy, int x, int y, int sx, int sy, quint16 *buffer)
+{
+    CHgtFile *hgt;
+    int col = index % tilesX;
+    int row = index / tilesX;
+
+    // longitude wraps around, latitude does not
+    row += dy;
+    col = (col + dx + tilesX) % tilesX;
+    if (row<0 || row>=tilesY || ! avab[row*tilesX + col].available)
+        return false;
+
+    hgt = tileCache->acquire(hgtSource, row*tilesX + col);
+    if (hgt==0)
+        return false;
+    hgt->getHeightBlock(buffer, x, y, sx, sy, 1);
+    tileCache->release(hgt);
+    return true;
+}
+
+void CReliefRenderer::loadWithHalo(int index, float *grid)
+{
+    CHgtFile *hgt;
+    quint16 *height, *halo;
+    int size = hgtSourceSize;
+    int g = size + 2;
+    int x, y, h;
+
+    // centre goes through cache too, it is neighbour of next tile
+    hgt = tileCache->acquire(hgtSource, index);
+    if (hgt!=0) {
+        height = hgt->getHeightBuffer();
+        for (y=0; y<size; y++)
+            for (x=0; x<size; x++)
+                grid[(y+1)*g + x+1] = (float)height[y*size + x];
+        tileCache->release(hgt);
+    } else {
+        for (y=0; y<size; y++)
+            for (x=0; x<size; x++)
+                grid[(y+1)*g + x+1] = 0.0f;
+    }
+
+    // edge samples are shared with neighbour, so halo is one sample further
+    halo = new quint16[size];
+    if (readNeighbour(index, 0, -1, 0, size-2, size, 1, halo))
+        for (x=0; x<size; x++) grid[x+1] = halo[x];
+    else
+        for (x=0; x<size; x++) grid[x+1] = grid[g + x+1];
+
+    if (readNeighbour(index, 0, 1, 0, 1, size, 1, halo))
+        for (x=0; x<size; x++) grid[(g-1)*g + x+1] = halo[x];
+    else
+        for (x=0; x<size; x++) grid[(g-1)*g + x+1] = grid[(g-2)*g + x+1];
+
+    if (readNeighbour(index, -1, 0, size-2, 0, 1, size, halo))
+        for (y=0; y<size; y++) grid[(y+1)*g] = halo[y];
+    else
+        for (y=0; y<size; y++) grid[(y+1)*g] = grid[(y+1)*g + 1];
+
+    if (readNeighbour(index, 1, 0, 1, 0, 1, size, halo))
+        for (y=0; y<size; y++) grid[(y+1)*g + g-1] = halo[y];
+    else
+        for (y=0; y<size; y++) grid[(y+1)*g + g-1] = grid[(y+1)*g + g-2];
+
+    // corners - diagonal neighbour or average of two edges
+    grid[0] = readNeighbour(index, -1, -1, size-2, size-2, 1, 1, halo) ? halo[0] : 0.5f*(grid[1] + grid[g]);
+    grid[g-1] = readNeighbour(index, 1, -1, 1, size-2, 1, 1, halo) ? halo[0] : 0.5f*(grid[g-2] + grid[2*g-1]);
+    grid[(g-1)*g] = readNeighbour(index, -1, 1, size-2, 1, 1, 1, halo) ? halo[0] : 0.5f*(grid[(g-2)*g] + grid[(g-1)*g + 1]);
+    grid[g*g-1] = readNeighbour(index, 1, 1, 1, 1, 1, 1, halo) ? halo[0] : 0.5f*(grid[(g-1)*g - 1] + grid[g*g-2]);
+    delete []halo;
+
+    // voids are flat sea level, see getColor
+    for (x=0; x<g*g; x++) {
+        h = (int)grid[x];
+        grid[x] = (h>9000) ? 0.0f : grid[x] * (float)zFactor;
+    }
+}
+
+CTilePipelineItem *CReliefRenderer::produce(int index)
+{
+    CReliefItem *item;
+    double tlLon, tlLat, lat;
+    int size = hgtSourceSize;
+    int g = size + 2;
+    float *grid, *p, *q, *shade;
+    float dx, dy, slope, aspect;
+    uchar *lineShade, *lineSlope, *lineAspect;
+    int x, y;
+
+    if ( ! avab[index].available)
+        return 0;
+
+    item = new CReliefItem();
+    resizer->cacheManager.convertAvabilityIndex2TopLeft(index, hgtSourceDegree, &tlLon, &tlLat);
+    resizer->cacheManager.convertLonLatToFileName(tlLon, tlLat, &item->filename);
+
+    grid = new float[g*g];
+    p = new float[size];
+    q = new float[size];
+    shade = new float[size];
+    loadWithHalo(index, grid);
+
+    item->hillshade = QImage(size, size, QImage::Format_Indexed8);
+    item->slope = QImage(size, size, QImage::Format_Indexed8);
+    item->aspect = QImage(size, size, QImage::Format_Indexed8);
+    item->hillshade.setColorTable(grayTable);
+    item->slope.setColorTable(grayTable);
+    item->aspect.setColorTable(grayTable);
+
+    dy = (float)( hgtSourceDegree / (size - 1) * RELIEF_METERS_DEGREE );
+    for (y=0; y<size; y++) {
+        lat = tlLat - y * hgtSourceDegree / (size - 1);
+        dx = dy * (float)qMax(cos(lat * (RELIEF_PI / 180.0)), 0.01);
+
+        hornRow(&grid[y*g], &grid[(y+1)*g], &grid[(y+2)*g], size, dx, dy, p, q);
+        shadeRow(p, q, size, azimuth, altitude, shade);
+
+        lineShade = item->hillshade.scanLine(y);
+        lineSlope = item->slope.scanLine(y);
+        lineAspect = item->aspect.scanLine(y);
+        for (x=0; x<size; x++) {
+            lineShade[x] = (uchar)(shade[x] * 255.0f + 0.5f);
+
+            slope = atanf(sqrtf(p[x]*p[x] + q[x]*q[x])) * (float)(180.0 / RELIEF_PI);
+            lineSlope[x] = (uchar)(slope * (255.0f / 90.0f) + 0.5f);
+
+            if (p[x]==0.0f && q[x]==0.0f) {
+                lineAspect[x] = 0;
+            } else {
+                aspect = atan2f(-p[x], -q[x]) * (float)(180.0 / RELIEF_PI);
+                if (aspect<0.0f) aspect += 360.0f;
+                lineAspect[x] = (uchar)(1.0f + aspect * (254.0f / 360.0f) + 0.5f);
+            }
+        }
+    }
+
+    delete []grid;
+    delete []p;
+    delete []q;
+    delete []shade;
+    return item;
+}
+
+void CReliefRenderer::consume(CTilePipelineItem *item)
+{
+    CReliefItem *reliefItem = (CReliefItem *)item;
+    CScopedTimer timer("imageEncode");
+
+    reliefItem->hillshade.save(pathDirIndex + reliefItem->filename + "_shade.png", "PNG");
+    reliefItem->slope.save(pathDirIndex + reliefItem->filename + "_slope.png", "PNG");
+    reliefItem->aspect.save(pathDirIndex + reliefItem->filename + "_aspect.png", "PNG");
+    CRunReport::getInstance()->count("imagesWritten", 3);
+}
+
+void CReliefRenderer::render(int hgtSource, double lon, double lat)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    QList<int> indexes;
+    double tlLon, tlLat;
+    int index;
+
+    this->hgtSource = hgtSource;
+    avab = cacheManager->getAvability(hgtSource);
+    hgtSourceSize = cacheManager->getSourceSize(hgtSource);
+    itemMemory = (qint64)(hgtSourceSize + 2)*(hgtSourceSize + 2)*MEMORY_JOB_RELIEF_SAMPLE;
+    hgtSourceDegree = cacheManager->getSourceDegreeSize(hgtSource);
+    tilesX = (int)( (360.0 / hgtSourceDegree) + 0.5 );
+    tilesY = (int)( (180.0 / hgtSourceDegree) + 0.5 );
+    pathDir = cacheManager->getPath(hgtSource);
+    pathDirIndex = cacheManager->getIndexPath(hgtSource);
+
+    if (lon!=-1.0 && lat!=-1.0) {
+        cacheManager->findTopLeftCorner(lon, lat, hgtSourceDegree, &tlLon, &tlLat);
+        cacheManager->convertTopLeft2AvabilityIndex(tlLon, tlLat, hgtSourceDegree, &index);
+        indexes.append(index);
+    } else {
+        for (index=0; index<tilesX*tilesY; index++)
+            if (avab[index].available)
+                indexes.append(index);
+    }
+
+    run(indexes, "Relief");
+}
@@ -0,0 +1,103 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CRELIEFRENDERER_H
+#define CRELIEFRENDERER_H
+
+#include <QString>
+#include <QImage>
+#include <QVector>
+#include "CTilePipeline.h"
+#include "CAvability.h"
+#include "CTileCache.h"
+
+class CResizer;
+
+class CReliefItem : public CTilePipelineItem
+{
+public:
+    QImage hillshade;
+    QImage slope;          // 0..90 deg -> 0..255
+    QImage aspect;         // 0 flat, 1..255 -> 0..360 deg clockwise from north (downslope)
+    QString filename;
+};
+
+// Shaded relief, slope and aspect rasters of tiles, written next to images
+// of HTML index. Gradients use Horn 3x3 stencil; one sample wide halo is
+// read from 8 neighbour tiles so there are no seams on tile edges. Tiles are
+// shared through cache, so every tile is loaded about once per row of tiles.
+class CReliefRenderer : public CTilePipeline
+{
+public:
+    double azimuth;        // deg, direction light comes from
+    double altitude;       // deg above horizon
+    double zFactor;
+
+    CReliefRenderer(CResizer *r);
+    ~CReliefRenderer();
+
+    void render(int hgtSource, double lon = -1.0, double lat = -1.0);
+
+    // Stencil over three rows of n+2 samples (north, middle, south), gives n
+    // gradients dz/dx (east) and dz/dy (north).
+    static void hornRow(const float *north, const float *middle, const float *south, int n,
+                        float dx, float dy, float *p, float *q);
+    // Lambert shading of n gradients, 0..1
+    static void shadeRow(const float *p, const float *q, int n, double azimuth, double altitude, float *shade);
+
+protected:
+    CTilePipelineItem *produce(int index);
+    void consume(CTilePipelineItem *item);
+
+private:
+    CResizer *resizer;
+    CAvability *avab;
+    CTileCache *tileCache;
+    int hgtSource;
+    int hgtSourceSize;
+    double hgtSourceDegree;
+    int tilesX;
+    int tilesY;
+    QString pathDir;
+    QString pathDirIndex;
+    QVector<QRgb> grayTable;
+
+    void loadWithHalo(int index, float *grid);
+    bool readNeighbour(int index, int dx, int dy, int x, int y, int sx, int sy, quint16 *buffer);
+};
+
+#endif // CRELIEFRENDERER_H
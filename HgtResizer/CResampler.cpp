@@ -0,0 +1,176 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <math.h>
+#include "CResampler.h"
+#include "CHgtCodec.h"
+#include "alglib/interpolation.h"
+
+CResampler::CResampler()
+{
+    constantBlocks = 0;
+    totalBlocks = 0;
+    oldSize = 0;
+    newSize = 0;
+    blocks = 0;
+    blockValue = 0;
+}
+
+CResampler::~CResampler()
+{
+}
+
+void CResampler::findConstantBlocks(CHgtFile *src)
+{
+    quint16 *height = src->getHeightBuffer();
+    int bx, by, x0, x1, y0, y1, v;
+    bool constant;
+
+    blocks = (oldSize + RESAMPLER_BLOCK - 1) / RESAMPLER_BLOCK;
+    constantBlocks = 0;
+    totalBlocks = blocks*blocks;
+
+    for (by=0; by<blocks; by++)
+        for (bx=0; bx<blocks; bx++) {
+            x0 = qMax(bx*RESAMPLER_BLOCK - RESAMPLER_MARGIN, 0);
+            y0 = qMax(by*RESAMPLER_BLOCK - RESAMPLER_MARGIN, 0);
+            x1 = qMin((bx+1)*RESAMPLER_BLOCK + RESAMPLER_MARGIN, oldSize) - 1;
+            y1 = qMin((by+1)*RESAMPLER_BLOCK + RESAMPLER_MARGIN, oldSize) - 1;
+            v = height[y0*oldSize + x0];
+            constant = CHgtCodec::isConstant(height + y0*oldSize + x0, oldSize, x1 - x0 + 1, y1 - y0 + 1);
+
+            blockValue[by*blocks + bx] = constant ? v : -1;
+            if (constant)
+                constantBlocks++;
+        }
+}
+
+void CResampler::resampleLine(const double *src, double *dst, const int *lineBlockValue)
+{
+    alglib::real_1d_array x, y;
+    alglib::spline1dinterpolant c;
+    double scale = (double)(oldSize - 1) / (double)(newSize - 1);
+    int k, kEnd, j, j0, j1, block, n;
+
+    k = 0;
+    while (k<newSize) {
+        block = (int)(k * scale) / RESAMPLER_BLOCK;
+        if (lineBlockValue[block]!=-1) {
+            dst[k] = lineBlockValue[block];
+            k++;
+            continue;
+        }
+
+        // stretch of outputs in non-constant blocks
+        kEnd = k;
+        while (kEnd+1<newSize && lineBlockValue[(int)((kEnd+1) * scale) / RESAMPLER_BLOCK]==-1)
+            kEnd++;
+
+        // nodes are the same as in spline2dresamplebicubic: j/(oldSize-1)
+        j0 = qMax((int)floor(k * scale) - RESAMPLER_MARGIN, 0);
+        j1 = qMin((int)ceil(kEnd * scale) + RESAMPLER_MARGIN, oldSize - 1);
+        n = j1 - j0 + 1;
+        x.setlength(n);
+        y.setlength(n);
+        for (j=j0; j<=j1; j++) {
+            x[j-j0] = (double)j / (double)(oldSize - 1);
+            y[j-j0] = src[j];
+        }
+        alglib::spline1dbuildcubic(x, y, n, 0, 0.0, 0, 0.0, c);
+        for (; k<=kEnd; k++)
+            dst[k] = alglib::spline1dcalc(c, (double)k / (double)(newSize - 1));
+    }
+}
+
+void CResampler::resample(CHgtFile *src, CHgtFile *dst)
+{
+    quint16 *height = src->getHeightBuffer();
+    double *buffer, *line, *column, *result;
+    int *lineBlockValue;
+    double scale;
+    int x, y, i;
+
+    oldSize = src->getSizeX();
+    newSize = dst->getSizeX();
+    blockValue = new int[((oldSize + RESAMPLER_BLOCK - 1) / RESAMPLER_BLOCK) * ((oldSize + RESAMPLER_BLOCK - 1) / RESAMPLER_BLOCK)];
+    findConstantBlocks(src);
+
+    // whole tile is constant (sea) - nothing to interpolate
+    if (constantBlocks==totalBlocks && blocks>0) {
+        for (i=1; i<totalBlocks && blockValue[i]==blockValue[0]; i++) ;
+        if (i==totalBlocks) {
+            for (y=0; y<newSize; y++)
+                for (x=0; x<newSize; x++)
+                    dst->setHeight(x, y, blockValue[0]);
+            delete []blockValue;
+            return;
+        }
+    }
+
+    buffer = new double[oldSize*newSize];
+    line = new double[oldSize];
+    column = new double[oldSize];
+    result = new double[newSize];
+    lineBlockValue = new int[blocks];
+
+    // horizontal - rows of source to rows of buffer (oldSize x newSize)
+    for (y=0; y<oldSize; y++) {
+        for (x=0; x<oldSize; x++)
+            line[x] = height[y*oldSize + x];
+        resampleLine(line, &buffer[y*newSize], &blockValue[(y / RESAMPLER_BLOCK) * blocks]);
+    }
+
+    // vertical - columns of buffer, constant block is the one of source column
+    scale = (double)(oldSize - 1) / (double)(newSize - 1);
+    for (x=0; x<newSize; x++) {
+        for (i=0; i<blocks; i++)
+            lineBlockValue[i] = blockValue[i*blocks + (int)(x * scale) / RESAMPLER_BLOCK];
+        for (y=0; y<oldSize; y++)
+            column[y] = buffer[y*newSize + x];
+        resampleLine(column, result, lineBlockValue);
+        for (y=0; y<newSize; y++)
+            dst->setHeight(x, y, (int)result[y]);
+    }
+
+    delete []buffer;
+    delete []line;
+    delete []column;
+    delete []result;
+    delete []lineBlockValue;
+    delete []blockValue;
+    blockValue = 0;
+}
@@ -0,0 +1,76 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CRESAMPLER_H
+#define CRESAMPLER_H
+
+#include "CHgtFile.h"
+
+#define RESAMPLER_BLOCK      64       // constant block detection size
+#define RESAMPLER_MARGIN     16       // block is widened by spline support
+
+// Bicubic resampling of terrain like alglib::spline2dresamplebicubic
+// (parabolically terminated cubic splines along rows, then along columns)
+// but constant areas (sea) are not interpolated. Grid is split to blocks,
+// block is constant when all samples of block widened by RESAMPLER_MARGIN
+// have the same height. Outputs inside constant blocks get the height
+// directly, splines are built only over non-constant stretches of
+// row/column widened by the margin. Such spline ends at the margin, not at
+// tile edge, so results are close to alglib, not equal: influence of end
+// condition drops ~3.7x per node, after 16 nodes it is far below 1 mm.
+class CResampler
+{
+public:
+    int constantBlocks;
+    int totalBlocks;
+
+    CResampler();
+    ~CResampler();
+
+    void resample(CHgtFile *src, CHgtFile *dst);
+
+private:
+    int oldSize;
+    int newSize;
+    int blocks;
+    int *blockValue;       // height of constant block, -1 = not constant
+
+    void findConstantBlocks(CHgtFile *src);
+    void resampleLine(const double *src, double *dst, const int *lineBlockValue);
+};
+
+#endif // CRESAMPLER_H
@@ -40,14 +40,45 @@
 #include <QDebug>
 #include <QImage>
 #include <QColor>
+#include <QThread>
 #include "CResizer.h"
 #include "CHgtFile.h"
-#include "alglib/interpolation.h"
+#include "CHgtCodec.h"
+#include "CTileStats.h"
+#include "CMinMaxTree.h"
+#include "CLodData.h"
+#include "CVoidFiller.h"
+#include "CResampler.h"
+#include "CIndexImagePipeline.h"
+#include "CRunReport.h"
+#include "CScopedTimer.h"
+#include "CTrace.h"
+#include "CLog.h"
+#include "CStitchStats.h"
+#include "CMemoryBudget.h"
 
 using namespace std;
 
 CResizer::CResizer()
 {
+    int i;
+
+    threadCount = QThread::idealThreadCount();
+    if (threadCount<1) threadCount = 1;
+    tileThreadCount = 0;
+    lossyMaxError[HGT_SOURCE_L00_L03] = 0;
+    lossyMaxError[HGT_SOURCE_L04_L08] = 0;
+    lossyMaxError[HGT_SOURCE_L09_L13] = 0;
+
+    // precomputed colors - getColor is too slow to call per pixel
+    colorLookUp = new unsigned int[65536];
+    for (i=0; i<65536; i++)
+        colorLookUp[i] = getColor(i);
+}
+
+CResizer::~CResizer()
+{
+    delete []colorLookUp;
 }
 
 bool CResizer::findSRTMFilesFor_L09_L13(const double &L09_L13_topLeftLon, const double &L09_L13_topLeftLat,
@@ -108,7 +139,7 @@ void CResizer::buildL09_L13TerrainFromSRTM(const double &lon, const double &lat)
     buildL09_L13TerrainFromSRTM(L09_L13_index);
 }
 
-void CResizer::buildL09_L13TerrainFromSRTM(int L09_L13_index)
+bool CResizer::buildL09_L13TerrainFromSRTM(int L09_L13_index)
 {
     int *buffer = new int[301*301];
     CHgtFile hgtL09_L13;
@@ -124,26 +155,33 @@ void CResizer::buildL09_L13TerrainFromSRTM(int L09_L13_index)
     int fileOffsetLon, fileOffsetLat;
     int fileLon, fileLat;
     double L09_L13_topLeftLon, L09_L13_topLeftLat;
-    alglib::real_2d_array real_2d_array;
-    alglib::real_2d_array real_2d_array_resized;
+    CResampler resampler;
+    CLodData lodData;
+    CVoidFiller voidFiller;
+    bool saved;
+    CTraceScope trace("tile", L09_L13_index);
+    CScopedTimer findTimer("find");
 
 
     cacheManager.convertAvabilityIndex2TopLeft(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, &L09_L13_topLeftLon, &L09_L13_topLeftLat);
 
 
-    qDebug() << "Terrain resizing:  " << QString::number(L09_L13_topLeftLon, 'f', 2) << "  "
+    LOG_INFO << "Terrain resizing:  " << QString::number(L09_L13_topLeftLon, 'f', 2) << "  "
                                       << QString::number(L09_L13_topLeftLat, 'f', 2) << "  "
                                       << L09_L13_index;
 
     // find SRTM files that contains data for new terrain tile (L09-L13)
-    qDebug() << "    Find & copy SRTM data...";
+    LOG_INFO << "    Find & copy SRTM data...";
     hasAtLeastOneSRTMFile = findSRTMFilesFor_L09_L13(L09_L13_topLeftLon, L09_L13_topLeftLat, SRTMfilesIndex, &offsetLon, &offsetLat);
+    findTimer.stop();
     if ( ! hasAtLeastOneSRTMFile) {
-        qDebug() << "    Find & copy SRTM data... no files, skipping";
+        LOG_INFO << "    Find & copy SRTM data... no files, skipping";
+        CRunReport::getInstance()->count("tilesSkipped");
         delete []buffer;
-        return;
+        return true;
     }
     // copy data from SRTM files
+    CScopedTimer copyTimer("copy");
     SRTMfilenamePrevious = "";
     hgtL09_L13.init(4501, 4501);
     for (y=0; y<15; y++)
@@ -158,7 +196,8 @@ void CResizer::buildL09_L13TerrainFromSRTM(int L09_L13_index)
                 SRTMfilename = cacheManager.avability_SRTM[SRTMfilesIndex[fileLat*5 + fileLon]].name;
                 if ((*SRTMfilename) != SRTMfilenamePrevious) {
                     SRTMfilenamePrevious = (*SRTMfilename);
-                    hgtSRTM.loadFile(cacheManager.pathSRTM + (*SRTMfilename), 1201, 1201);
+                    // voids filled from lower priority SRTM sources
+                    cacheManager.loadSRTMFile(SRTMfilesIndex[fileLat*5 + fileLon], &hgtSRTM);
                 }
                 hgtSRTM.getHeightBlock(buffer, fileOffsetLon*300, fileOffsetLat*300, 301, 301, 1);
             } else {
@@ -170,35 +209,43 @@ void CResizer::buildL09_L13TerrainFromSRTM(int L09_L13_index)
             // set copied data to new terrain tile (L09-L13)
             hgtL09_L13.setHeightBlock(buffer, x*300, y*300, 301, 301, 1);
         }
-    qDebug() << "    Find & copy SRTM data... OK";
+    copyTimer.stop();
+    LOG_INFO << "    Find & copy SRTM data... OK";
 
 
-    qDebug() << "    [alglib] Load & resize data...";
-    real_2d_array.setlength(4501, 4501);
-    real_2d_array_resized.setlength(4097, 4097);
-    for (y=0; y<4501; y++)
-        for (x=0; x<4501; x++) {
-            if (hgtL09_L13.getHeight(x, y)>9000)
-                real_2d_array[y][x] = 10.0; else
-                real_2d_array[y][x] = (double)hgtL09_L13.getHeight(x, y);
-        }
-    // bicubic resizing from 4501x4501 to 4097x4097
-    alglib::spline2dresamplebicubic(real_2d_array, 4501, 4501, real_2d_array_resized, 4097, 4097);
+    // voids would make pits and spline ringing - fill them before resizing
+    LOG_INFO << "    Fill voids...";
+    CScopedTimer fillTimer("fillVoids");
+    voidFiller.threadCount = (tileThreadCount>0) ? tileThreadCount : threadCount;
+    voidFiller.fill(&hgtL09_L13);
+    fillTimer.stop();
+    LOG_INFO << "    Fill voids... OK";
+
+    LOG_INFO << "    [alglib] Load & resize data...";
+    // bicubic resizing from 4501x4501 to 4097x4097, sea blocks are only copied
+    CScopedTimer resampleTimer("resample");
     hgtL09_L13_resized.init(4097, 4097);
-    for (y=0; y<4097; y++)
-        for (x=0; x<4097; x++) {
-            hgtL09_L13_resized.setHeight(x, y, (int)real_2d_array_resized[y][x]);
-        }
-    qDebug() << "    [alglib] Load & resize data... OK";
+    resampler.resample(&hgtL09_L13, &hgtL09_L13_resized);
+    resampleTimer.stop();
+    LOG_INFO << "    constant blocks: " << resampler.constantBlocks << " / " << resampler.totalBlocks;
+    LOG_INFO << "    [alglib] Load & resize data... OK";
 
     // find terrain filename and save
-    qDebug() << "    Save resized HGT file...";
+    LOG_INFO << "    Save resized HGT file...";
     cacheManager.convertLonLatToFileName(L09_L13_topLeftLon, L09_L13_topLeftLat, &hgtL09_L13_resizedFilename);
-    hgtL09_L13_resized.saveFile(cacheManager.pathL09_L13 + hgtL09_L13_resizedFilename);
-    qDebug() << "    Save resized HGT file... OK";
+    lodData.init(HGT_SOURCE_L09_L13);
+    saved = saveFileWithStats(&hgtL09_L13_resized, HGT_SOURCE_L09_L13, cacheManager.pathL09_L13 + hgtL09_L13_resizedFilename,
+                              &lodData, L09_L13_topLeftLat);
+    if (saved) {
+        LOG_INFO << "    Save resized HGT file... OK";
+        CRunReport::getInstance()->count("tilesProcessed");
+    } else {
+        LOG_ERROR << "    Save resized HGT file... failed";
+    }
 
 
     delete []buffer;
+    return saved;
 }
 
 void CResizer::connectL09_L13TerrainEntireEarth()
@@ -208,20 +255,62 @@ void CResizer::connectL09_L13TerrainEntireEarth()
     for (L09_L13_index=0; L09_L13_index<96*48; L09_L13_index++) {
         connectL09_L13Terrain(L09_L13_index);
     }
+    for (L09_L13_index=0; L09_L13_index<96*48; L09_L13_index++) {
+        rebuildL09_L13Sidecars(L09_L13_index);
+    }
 }
 
 void CResizer::connectL09_L13Terrain(const double &lon, const double &lat)
 {
     double tlLon, tlLat;
-    int L09_L13_index;
+    int L09_L13_index, neighbor, i;
 
     cacheManager.findTopLeftCorner(lon, lat, HGT_SOURCE_DEGREE_SIZE_L09_L13, &tlLon, &tlLat);
     cacheManager.convertTopLeft2AvabilityIndex(tlLon, tlLat, HGT_SOURCE_DEGREE_SIZE_L09_L13, &L09_L13_index);
 
     connectL09_L13Terrain(L09_L13_index);
+    // edges of all 9 tiles could change
+    for (i=0; i<9; i++) {
+        neighbor = cacheManager.getNeighborAvabilityIndex(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, i%3 - 1, i/3 - 1);
+        if (neighbor!=-1)
+            rebuildL09_L13Sidecars(neighbor);
+    }
+}
+
+bool CResizer::rebuildL09_L13Sidecars(int L09_L13_index)
+{
+    CHgtFile hgt;
+    CLodData lodData;
+    QString filename;
+    double tlLon, tlLat;
+    bool saved;
+    CTraceScope trace("tile", L09_L13_index);
+
+    if ( ! cacheManager.avability_L09_L13[L09_L13_index].available) return true;
+
+    cacheManager.convertAvabilityIndex2TopLeft(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, &tlLon, &tlLat);
+    cacheManager.convertLonLatToFileName(tlLon, tlLat, &filename);
+    LOG_INFO << "Sidecars of stitched tile:  " << QString::number(tlLon, 'f', 2) << "  "
+                                               << QString::number(tlLat, 'f', 2) << "  "
+                                               << L09_L13_index;
+
+    // statistics, min/max tree and LOD data of stored heights
+    hgt.loadTile(&cacheManager.avability_L09_L13[L09_L13_index], cacheManager.pathL09_L13, 4097, 4097);
+    CScopedTimer sidecarsTimer("sidecars");
+    lodData.init(HGT_SOURCE_L09_L13);
+    lodData.compute(&hgt, tlLat);
+    saved = saveSidecars(&hgt, HGT_SOURCE_L09_L13, cacheManager.pathL09_L13 + filename, &lodData);
+
+    // edges are final now, raw tile of build is stored encoded if smaller
+    if (saved && cacheManager.avability_L09_L13[L09_L13_index].archive==0 && CHgtFile::saveEncoding!=HGT_ENCODING_RAW)
+        saved = hgt.saveFileEncoded(cacheManager.avability_L09_L13[L09_L13_index].getFilePath(cacheManager.pathL09_L13));
+
+    if ( ! saved)
+        LOG_ERROR << "    Save sidecars of stitched tile... failed";
+    return saved;
 }
 
-void CResizer::connectL09_L13Terrain(int L09_L13_index)
+bool CResizer::connectL09_L13Terrain(int L09_L13_index)
 {
     CHgtFile hgtNW, hgtN, hgtNE;
     CHgtFile hgtW, hgtBase, hgtE;
@@ -238,20 +327,35 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
     double L09_L13_topLeftLon, L09_L13_topLeftLat;
     double roundedHgt;
     int roundedHgtInt;
-    int x, y;
+    int x, y, neighbor, i;
     bool save = true;
+    bool closed = true;
+    CStitchStats stitchStats;
+    CTraceScope trace("tile", L09_L13_index);
 
     cacheManager.convertAvabilityIndex2TopLeft(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, &L09_L13_topLeftLon, &L09_L13_topLeftLat);
 
-    qDebug() << "Terrain connecting:  " << QString::number(L09_L13_topLeftLon, 'f', 2) << "  "
+    LOG_INFO << "Terrain connecting:  " << QString::number(L09_L13_topLeftLon, 'f', 2) << "  "
                                         << QString::number(L09_L13_topLeftLat, 'f', 2) << "  "
                                         << L09_L13_index;
 
     if ( ! cacheManager.avability_L09_L13[L09_L13_index].available) {
-        qDebug() << "    No terrain... skipping";
-        return;
+        LOG_INFO << "    No terrain... skipping";
+        CRunReport::getInstance()->count("tilesSkipped");
+        return true;
+    }
+
+    // archived tiles are read only, stitched edges would be dropped silently
+    for (i=0; i<9; i++) {
+        neighbor = cacheManager.getNeighborAvabilityIndex(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, i%3 - 1, i/3 - 1);
+        if (neighbor!=-1 && cacheManager.avability_L09_L13[neighbor].available && cacheManager.avability_L09_L13[neighbor].archive!=0) {
+            LOG_ERROR << "Tile" << neighbor << "is archived, unpack L09_L13 before connecting";
+            return false;
+        }
     }
 
+    CScopedTimer stitchTimer("stitch");
+
     // NW neighbor
     hgtNWinx = cacheManager.getNeighborAvabilityIndex(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, -1, -1);
     if (hgtNWinx!=-1) hgtNWav = cacheManager.avability_L09_L13[hgtNWinx].available; else
@@ -304,16 +408,16 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
 //    qDebug() << hgtWfn  << " " << hgtBasefn << " " << hgtEfn;
 //    qDebug() << hgtSWfn << " " << hgtSfn    << " " << hgtSEfn;
 
-    // open files
-    if (hgtNWav) hgtNW.fileOpen(cacheManager.pathL09_L13 + hgtNWfn, 4097, 4097);
-    if (hgtNav)  hgtN.fileOpen(cacheManager.pathL09_L13 + hgtNfn, 4097, 4097);
-    if (hgtNEav) hgtNE.fileOpen(cacheManager.pathL09_L13 + hgtNEfn, 4097, 4097);
-    if (hgtWav)    hgtW.fileOpen(cacheManager.pathL09_L13 + hgtWfn, 4097, 4097);
-    if (hgtBaseav) hgtBase.fileOpen(cacheManager.pathL09_L13 + hgtBasefn, 4097, 4097);
-    if (hgtEav)    hgtE.fileOpen(cacheManager.pathL09_L13 + hgtEfn, 4097, 4097);
-    if (hgtSWav) hgtSW.fileOpen(cacheManager.pathL09_L13 + hgtSWfn, 4097, 4097);
-    if (hgtSav)  hgtS.fileOpen(cacheManager.pathL09_L13 + hgtSfn, 4097, 4097);
-    if (hgtSEav) hgtSE.fileOpen(cacheManager.pathL09_L13 + hgtSEfn, 4097, 4097);
+    // open files, tiles found only in archive are read only
+    if (hgtNWav) hgtNW.fileOpenTile(&cacheManager.avability_L09_L13[hgtNWinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtNav)  hgtN.fileOpenTile(&cacheManager.avability_L09_L13[hgtNinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtNEav) hgtNE.fileOpenTile(&cacheManager.avability_L09_L13[hgtNEinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtWav)    hgtW.fileOpenTile(&cacheManager.avability_L09_L13[hgtWinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtBaseav) hgtBase.fileOpenTile(&cacheManager.avability_L09_L13[hgtBaseinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtEav)    hgtE.fileOpenTile(&cacheManager.avability_L09_L13[hgtEinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtSWav) hgtSW.fileOpenTile(&cacheManager.avability_L09_L13[hgtSWinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtSav)  hgtS.fileOpenTile(&cacheManager.avability_L09_L13[hgtSinx], cacheManager.pathL09_L13, 4097, 4097);
+    if (hgtSEav) hgtSE.fileOpenTile(&cacheManager.avability_L09_L13[hgtSEinx], cacheManager.pathL09_L13, 4097, 4097);
 
     // corner NW
     roundedHgt = 0.0;
@@ -322,10 +426,10 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
     if (hgtWav)    { roundedHgt = roundedHgt + (double)hgtW.fileGetHeight(4096, 0); }
     if (hgtNav)    { roundedHgt = roundedHgt + (double)hgtN.fileGetHeight(0, 4096); }
     roundedHgtInt = (int)((roundedHgt / 4.0) + 0.5);
-    if (hgtBaseav) { if (hgtBase.fileGetHeight(0, 0)!=roundedHgtInt)     { qDebug() << "[NW] Base: " << hgtBase.fileGetHeight(0, 0)     << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(0, 0, roundedHgtInt); } }
-    if (hgtNWav)   { if (hgtNW.fileGetHeight(4096, 4096)!=roundedHgtInt) { qDebug() << "[NW] NW:   " << hgtNW.fileGetHeight(4096, 4096) << "!=" << roundedHgtInt; if (save) hgtNW.fileSetHeight(4096, 4096, roundedHgtInt); } };
-    if (hgtWav)    { if (hgtW.fileGetHeight(4096, 0)!=roundedHgtInt)     { qDebug() << "[NW] W:    " << hgtW.fileGetHeight(4096, 0)     << "!=" << roundedHgtInt; if (save) hgtW.fileSetHeight(4096, 0, roundedHgtInt); } }
-    if (hgtNav)    { if (hgtN.fileGetHeight(0, 4096)!=roundedHgtInt)     { qDebug() << "[NW] N:    " << hgtN.fileGetHeight(0, 4096)     << "!=" << roundedHgtInt; if (save) hgtN.fileSetHeight(0, 4096, roundedHgtInt); } }
+    if (hgtBaseav) stitchStats.check(&hgtBase, 0, 0, roundedHgtInt, CStitchStats::CORNER_NW, "Base", save);
+    if (hgtNWav)   stitchStats.check(&hgtNW, 4096, 4096, roundedHgtInt, CStitchStats::CORNER_NW, "NW", save);
+    if (hgtWav)    stitchStats.check(&hgtW, 4096, 0, roundedHgtInt, CStitchStats::CORNER_NW, "W", save);
+    if (hgtNav)    stitchStats.check(&hgtN, 0, 4096, roundedHgtInt, CStitchStats::CORNER_NW, "N", save);
 
     // corner NE
     roundedHgt = 0.0;
@@ -334,10 +438,10 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
     if (hgtEav)    { roundedHgt = roundedHgt + (double)hgtE.fileGetHeight(0, 0); }
     if (hgtNav)    { roundedHgt = roundedHgt + (double)hgtN.fileGetHeight(4096, 4096); }
     roundedHgtInt = (int)((roundedHgt / 4.0) + 0.5);
-    if (hgtBaseav) { if (hgtBase.fileGetHeight(4096, 0)!=roundedHgtInt)    { qDebug() << "[NE] Base: " << hgtBase.fileGetHeight(4096, 0)    << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(4096, 0, roundedHgtInt); } }
-    if (hgtNEav)   { if (hgtNE.fileGetHeight(0, 4096)!=roundedHgtInt)   { qDebug() << "[NE] NE:   " << hgtNE.fileGetHeight(0, 4096)   << "!=" << roundedHgtInt; if (save) hgtNE.fileSetHeight(0, 4096, roundedHgtInt); } };
-    if (hgtEav)    { if (hgtE.fileGetHeight(0, 0)!=roundedHgtInt)       { qDebug() << "[NE] E:    " << hgtE.fileGetHeight(0, 0)       << "!=" << roundedHgtInt; if (save) hgtE.fileSetHeight(0, 0, roundedHgtInt); } }
-    if (hgtNav)    { if (hgtN.fileGetHeight(4096, 4096)!=roundedHgtInt) { qDebug() << "[NE] N:    " << hgtN.fileGetHeight(4096, 4096) << "!=" << roundedHgtInt; if (save) hgtN.fileSetHeight(4096, 4096, roundedHgtInt); } }
+    if (hgtBaseav) stitchStats.check(&hgtBase, 4096, 0, roundedHgtInt, CStitchStats::CORNER_NE, "Base", save);
+    if (hgtNEav)   stitchStats.check(&hgtNE, 0, 4096, roundedHgtInt, CStitchStats::CORNER_NE, "NE", save);
+    if (hgtEav)    stitchStats.check(&hgtE, 0, 0, roundedHgtInt, CStitchStats::CORNER_NE, "E", save);
+    if (hgtNav)    stitchStats.check(&hgtN, 4096, 4096, roundedHgtInt, CStitchStats::CORNER_NE, "N", save);
 
     // corner SW
     roundedHgt = 0.0;
@@ -346,10 +450,10 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
     if (hgtWav)    { roundedHgt = roundedHgt + (double)hgtW.fileGetHeight(4096, 4096); }
     if (hgtSav)    { roundedHgt = roundedHgt + (double)hgtS.fileGetHeight(0, 0); }
     roundedHgtInt = (int)((roundedHgt / 4.0) + 0.5);
-    if (hgtBaseav) { if (hgtBase.fileGetHeight(0, 4096)!=roundedHgtInt) { qDebug() << "[SW] Base: " << hgtBase.fileGetHeight(0, 4096) << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(0, 4096, roundedHgtInt); } }
-    if (hgtSWav)   { if (hgtSW.fileGetHeight(4096, 0)!=roundedHgtInt)   { qDebug() << "[SW] SW:   " << hgtSW.fileGetHeight(4096, 0)   << "!=" << roundedHgtInt; if (save) hgtSW.fileSetHeight(4096, 0, roundedHgtInt); } };
-    if (hgtWav)    { if (hgtW.fileGetHeight(4096, 4096)!=roundedHgtInt) { qDebug() << "[SW] W:    " << hgtW.fileGetHeight(4096, 4096) << "!=" << roundedHgtInt; if (save) hgtW.fileSetHeight(4096, 4096, roundedHgtInt); } }
-    if (hgtSav)    { if (hgtS.fileGetHeight(0, 0)!=roundedHgtInt)       { qDebug() << "[SW] S:    " << hgtS.fileGetHeight(0, 0)       << "!=" << roundedHgtInt; if (save) hgtS.fileSetHeight(0, 0, roundedHgtInt); } }
+    if (hgtBaseav) stitchStats.check(&hgtBase, 0, 4096, roundedHgtInt, CStitchStats::CORNER_SW, "Base", save);
+    if (hgtSWav)   stitchStats.check(&hgtSW, 4096, 0, roundedHgtInt, CStitchStats::CORNER_SW, "SW", save);
+    if (hgtWav)    stitchStats.check(&hgtW, 4096, 4096, roundedHgtInt, CStitchStats::CORNER_SW, "W", save);
+    if (hgtSav)    stitchStats.check(&hgtS, 0, 0, roundedHgtInt, CStitchStats::CORNER_SW, "S", save);
 
     // corner SE
     roundedHgt = 0.0;
@@ -358,10 +462,10 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
     if (hgtEav)    { roundedHgt = roundedHgt + (double)hgtE.fileGetHeight(0, 4096); }
     if (hgtSav)    { roundedHgt = roundedHgt + (double)hgtS.fileGetHeight(4096, 0); }
     roundedHgtInt = (int)((roundedHgt / 4.0) + 0.5);
-    if (hgtBaseav) { if (hgtBase.fileGetHeight(4096, 4096)!=roundedHgtInt) { qDebug() << "[SE] Base: " << hgtBase.fileGetHeight(4096, 4096) << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(4096, 4096, roundedHgtInt); } }
-    if (hgtSEav)   { if (hgtSE.fileGetHeight(0, 0)!=roundedHgtInt)         { qDebug() << "[SE] SE:   " << hgtSE.fileGetHeight(0, 0)         << "!=" << roundedHgtInt; if (save) hgtSE.fileSetHeight(0, 0, roundedHgtInt); } };
-    if (hgtEav)    { if (hgtE.fileGetHeight(0, 4096)!=roundedHgtInt)       { qDebug() << "[SE] E:    " << hgtE.fileGetHeight(0, 4096)       << "!=" << roundedHgtInt; if (save) hgtE.fileSetHeight(0, 4096, roundedHgtInt); } }
-    if (hgtSav)    { if (hgtS.fileGetHeight(4096, 0)!=roundedHgtInt)       { qDebug() << "[SE] S:    " << hgtS.fileGetHeight(4096, 0)       << "!=" << roundedHgtInt; if (save) hgtS.fileSetHeight(4096, 0, roundedHgtInt); } }
+    if (hgtBaseav) stitchStats.check(&hgtBase, 4096, 4096, roundedHgtInt, CStitchStats::CORNER_SE, "Base", save);
+    if (hgtSEav)   stitchStats.check(&hgtSE, 0, 0, roundedHgtInt, CStitchStats::CORNER_SE, "SE", save);
+    if (hgtEav)    stitchStats.check(&hgtE, 0, 4096, roundedHgtInt, CStitchStats::CORNER_SE, "E", save);
+    if (hgtSav)    stitchStats.check(&hgtS, 4096, 0, roundedHgtInt, CStitchStats::CORNER_SE, "S", save);
 
     // line N
     for (x=1; x<4096; x++) {
@@ -369,8 +473,8 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
         if (hgtBaseav) { roundedHgt = roundedHgt + (double)hgtBase.fileGetHeight(x, 0); }
         if (hgtNav)    { roundedHgt = roundedHgt + (double)hgtN.fileGetHeight(x, 4096); }
         roundedHgtInt = (int)((roundedHgt / 2.0) + 0.5);
-        if (hgtBaseav) { if (hgtBase.fileGetHeight(x, 0)!=roundedHgtInt) { qDebug() << "[N -" << x << "] Base: " << hgtBase.fileGetHeight(x, 0)     << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(x, 0, roundedHgtInt); } }
-        if (hgtNav)    { if (hgtN.fileGetHeight(x, 4096)!=roundedHgtInt) { qDebug() << "[N -" << x << "] N:    " << hgtN.fileGetHeight(x, 4096)     << "!=" << roundedHgtInt; if (save) hgtN.fileSetHeight(x, 4096, roundedHgtInt); } }
+        if (hgtBaseav) stitchStats.check(&hgtBase, x, 0, roundedHgtInt, CStitchStats::EDGE_N, "Base", save);
+        if (hgtNav)    stitchStats.check(&hgtN, x, 4096, roundedHgtInt, CStitchStats::EDGE_N, "N", save);
     }
 
     // line S
@@ -379,8 +483,8 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
         if (hgtBaseav) { roundedHgt = roundedHgt + (double)hgtBase.fileGetHeight(x, 4096); }
         if (hgtSav)    { roundedHgt = roundedHgt + (double)hgtS.fileGetHeight(x, 0); }
         roundedHgtInt = (int)((roundedHgt / 2.0) + 0.5);
-        if (hgtBaseav) { if (hgtBase.fileGetHeight(x, 4096)!=roundedHgtInt) { qDebug() << "[S -" << x << "] Base: " << hgtBase.fileGetHeight(x, 4096) << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(x, 4096, roundedHgtInt); } }
-        if (hgtSav)    { if (hgtS.fileGetHeight(x, 0)!=roundedHgtInt)       { qDebug() << "[S -" << x << "] S:    " << hgtS.fileGetHeight(x, 0)       << "!=" << roundedHgtInt; if (save) hgtS.fileSetHeight(x, 0, roundedHgtInt); } }
+        if (hgtBaseav) stitchStats.check(&hgtBase, x, 4096, roundedHgtInt, CStitchStats::EDGE_S, "Base", save);
+        if (hgtSav)    stitchStats.check(&hgtS, x, 0, roundedHgtInt, CStitchStats::EDGE_S, "S", save);
     }
 
     // line W
@@ -389,8 +493,8 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
         if (hgtBaseav) { roundedHgt = roundedHgt + (double)hgtBase.fileGetHeight(0, y); }
         if (hgtWav)    { roundedHgt = roundedHgt + (double)hgtW.fileGetHeight(4096, y); }
         roundedHgtInt = (int)((roundedHgt / 2.0) + 0.5);
-        if (hgtBaseav) { if (hgtBase.fileGetHeight(0, y)!=roundedHgtInt) { qDebug() << "[W -" << y << "] Base: " << hgtBase.fileGetHeight(0, y) << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(0, y, roundedHgtInt); } }
-        if (hgtWav)    { if (hgtW.fileGetHeight(4096, y)!=roundedHgtInt) { qDebug() << "[W -" << y << "] W:    " << hgtW.fileGetHeight(4096, y) << "!=" << roundedHgtInt; if (save) hgtW.fileSetHeight(4096, y, roundedHgtInt); } }
+        if (hgtBaseav) stitchStats.check(&hgtBase, 0, y, roundedHgtInt, CStitchStats::EDGE_W, "Base", save);
+        if (hgtWav)    stitchStats.check(&hgtW, 4096, y, roundedHgtInt, CStitchStats::EDGE_W, "W", save);
     }
 
     // line E
@@ -399,20 +503,31 @@ void CResizer::connectL09_L13Terrain(int L09_L13_index)
         if (hgtBaseav) { roundedHgt = roundedHgt + (double)hgtBase.fileGetHeight(4096, y); }
         if (hgtEav)    { roundedHgt = roundedHgt + (double)hgtE.fileGetHeight(0, y); }
         roundedHgtInt = (int)((roundedHgt / 2.0) + 0.5);
-        if (hgtBaseav) { if (hgtBase.fileGetHeight(4096, y)!=roundedHgtInt) { qDebug() << "[E -" << y << "] Base: " << hgtBase.fileGetHeight(4096, y) << "!=" << roundedHgtInt; if (save) hgtBase.fileSetHeight(4096, y, roundedHgtInt); } }
-        if (hgtEav)    { if (hgtE.fileGetHeight(0, y)!=roundedHgtInt)       { qDebug() << "[E -" << y << "] E:    " << hgtE.fileGetHeight(0, y)       << "!=" << roundedHgtInt; if (save) hgtE.fileSetHeight(0, y, roundedHgtInt); } }
+        if (hgtBaseav) stitchStats.check(&hgtBase, 4096, y, roundedHgtInt, CStitchStats::EDGE_E, "Base", save);
+        if (hgtEav)    stitchStats.check(&hgtE, 0, y, roundedHgtInt, CStitchStats::EDGE_E, "E", save);
     }
 
-    // close files
-    if (hgtNWav) hgtNW.fileClose();
-    if (hgtNav)  hgtN.fileClose();
-    if (hgtNEav) hgtNE.fileClose();
-    if (hgtWav)    hgtW.fileClose();
-    if (hgtBaseav) hgtBase.fileClose();
-    if (hgtEav)    hgtE.fileClose();
-    if (hgtSWav) hgtSW.fileClose();
-    if (hgtSav)  hgtS.fileClose();
-    if (hgtSEav) hgtSE.fileClose();
+    LOG_INFO << "    Mismatched samples: " << stitchStats.getMismatches() << ", max delta: " << stitchStats.getMaxDelta();
+    if ( ! stitchStats.appendFile(STITCH_STATS_FILENAME, L09_L13_index, L09_L13_topLeftLon, L09_L13_topLeftLat)) {
+        LOG_WARNING << "Can't write" << STITCH_STATS_FILENAME;
+    }
+
+    // close files, every tile is closed even if one fails
+    if (hgtNWav) closed = hgtNW.fileClose() && closed;
+    if (hgtNav)  closed = hgtN.fileClose() && closed;
+    if (hgtNEav) closed = hgtNE.fileClose() && closed;
+    if (hgtWav)    closed = hgtW.fileClose() && closed;
+    if (hgtBaseav) closed = hgtBase.fileClose() && closed;
+    if (hgtEav)    closed = hgtE.fileClose() && closed;
+    if (hgtSWav) closed = hgtSW.fileClose() && closed;
+    if (hgtSav)  closed = hgtS.fileClose() && closed;
+    if (hgtSEav) closed = hgtSE.fileClose() && closed;
+    if ( ! closed) {
+        LOG_ERROR << "    Write stitched edges... failed";
+        return false;
+    }
+    CRunReport::getInstance()->count("tilesProcessed");
+    return true;
 }
 
 void CResizer::buildL04_L08TerrainFromL09_L13EntireEarth()
@@ -435,21 +550,23 @@ void CResizer::buildL04_L08TerrainFromL09_L13(const double &lon, const double &l
     buildL04_L08TerrainFromL09_L13(L04_L08_index);
 }
 
-void CResizer::buildL04_L08TerrainFromL09_L13(int L04_L08_index)
+bool CResizer::buildL04_L08TerrainFromL09_L13(int L04_L08_index)
 {
     double L04_L08_topLeftLon, L04_L08_topLeftLat;
     int *buffer = new int[129*129];
     bool hasAtLeastOneL09_L13;
     int index;
     int L09_L13_index;
-    QString hgtFilename[4*4];
+    CAvability *hgtAvability[4*4];
     QString hgtFilenameResult;
     CHgtFile hgt_L09_L13;
     CHgtFile hgt_L04_L08;
+    CLodData lodData;
     int x, y, i;
+    CTraceScope trace("tile", L04_L08_index);
 
     cacheManager.convertAvabilityIndex2TopLeft(L04_L08_index, HGT_SOURCE_DEGREE_SIZE_L04_L08, &L04_L08_topLeftLon, &L04_L08_topLeftLat);
-    qDebug() << "L09_L13 to L04_L08:  " << QString::number(L04_L08_topLeftLon, 'f', 2) << "  "
+    LOG_INFO << "L09_L13 to L04_L08:  " << QString::number(L04_L08_topLeftLon, 'f', 2) << "  "
                                         << QString::number(L04_L08_topLeftLat, 'f', 2) << "  "
                                         << L04_L08_index;
 
@@ -457,31 +574,39 @@ void CResizer::buildL04_L08TerrainFromL09_L13(int L04_L08_index)
     cacheManager.convertTopLeft2AvabilityIndex(L04_L08_topLeftLon, L04_L08_topLeftLat, HGT_SOURCE_DEGREE_SIZE_L09_L13, &L09_L13_index);
 
     // get filenames of data in upper level
+    CScopedTimer findTimer("find");
     hasAtLeastOneL09_L13 = false;
     for (y=0; y<4; y++)
         for (x=0; x<4; x++) {
             index = cacheManager.getNeighborAvabilityIndex(L09_L13_index, HGT_SOURCE_DEGREE_SIZE_L09_L13, x, y);
 
-            hgtFilename[y*4 + x] = "";
+            hgtAvability[y*4 + x] = 0;
             if (index!=-1)
                 if (cacheManager.avability_L09_L13[index].available) {
-                    hgtFilename[y*4 + x] = (*cacheManager.avability_L09_L13[index].name);
+                    hgtAvability[y*4 + x] = &cacheManager.avability_L09_L13[index];
                     hasAtLeastOneL09_L13 = true;
                 }
         }
+    findTimer.stop();
 
 
     // if files was found copy data to lower LOD
     if (hasAtLeastOneL09_L13) {
 
-        qDebug() << "    Copy data with skipping...";
+        LOG_INFO << "    Copy data with skipping...";
+        CScopedTimer decimateTimer("decimate");
         hgt_L04_L08.init(513, 513);
+        lodData.init(HGT_SOURCE_L04_L08);
         for (y=0; y<4; y++)
             for (x=0; x<4; x++) {
 
-                if (hgtFilename[y*4 + x]!="") {
-                    hgt_L09_L13.loadFile(cacheManager.pathL09_L13 + hgtFilename[y*4 + x], 4097, 4097);
+                if (hgtAvability[y*4 + x]!=0) {
+                    // only rows used by decimation and LOD error are decoded
+                    hgt_L09_L13.loadTile(hgtAvability[y*4 + x], cacheManager.pathL09_L13, 4097, 4097,
+                                         cacheManager.HGTsourceSkippingLookUp[9]);
                     hgt_L09_L13.getHeightBlock(buffer, 0, 0, 129, 129, 32);
+                    // LOD 8 error against LOD 9 while L09_L13 tile is loaded
+                    lodData.accumulateError(8, &hgt_L09_L13, cacheManager.HGTsourceSkippingLookUp[9], x*16, y*16, 16);
                 } else {
                     for (i=0; i<129*129; i++)
                         buffer[i] = 0;
@@ -490,19 +615,29 @@ void CResizer::buildL04_L08TerrainFromL09_L13(int L04_L08_index)
                 hgt_L04_L08.setHeightBlock(buffer, x*128, y*128, 129, 129, 1);
             }
 
+        decimateTimer.stop();
+
         cacheManager.convertLonLatToFileName(L04_L08_topLeftLon, L04_L08_topLeftLat, &hgtFilenameResult);
-        hgt_L04_L08.saveFile(cacheManager.pathL04_L08 + hgtFilenameResult);
-        qDebug() << "    Copy data with skipping... OK";
+        if ( ! saveFileWithStats(&hgt_L04_L08, HGT_SOURCE_L04_L08, cacheManager.pathL04_L08 + hgtFilenameResult,
+                                 &lodData, L04_L08_topLeftLat)) {
+            LOG_ERROR << "    Copy data with skipping... save failed";
+            delete []buffer;
+            return false;
+        }
+        LOG_INFO << "    Copy data with skipping... OK";
+        CRunReport::getInstance()->count("tilesProcessed");
 
     } else {
 
-        qDebug() << "    No terrain in upper level... skipping";
+        LOG_INFO << "    No terrain in upper level... skipping";
+        CRunReport::getInstance()->count("tilesSkipped");
         delete []buffer;
-        return;
+        return true;
 
     }
 
     delete []buffer;
+    return true;
 }
 
 void CResizer::buildL00_L03TerrainFromL04_L08EntireEarth()
@@ -525,21 +660,23 @@ void CResizer::buildL00_L03TerrainFromL04_L08(const double &lon, const double &l
     buildL00_L03TerrainFromL04_L08(L00_L03_index);
 }
 
-void CResizer::buildL00_L03TerrainFromL04_L08(int L00_L03_index)
+bool CResizer::buildL00_L03TerrainFromL04_L08(int L00_L03_index)
 {
     double L00_L03_topLeftLon, L00_L03_topLeftLat;
     int *buffer = new int[17*17];
     bool hasAtLeastOneL04_L08;
     int index;
     int L04_L08_index;
-    QString hgtFilename[4*4];
+    CAvability *hgtAvability[4*4];
     QString hgtFilenameResult;
     CHgtFile hgt_L04_L08;
     CHgtFile hgt_L00_L03;
+    CLodData lodData;
     int x, y, i;
+    CTraceScope trace("tile", L00_L03_index);
 
     cacheManager.convertAvabilityIndex2TopLeft(L00_L03_index, HGT_SOURCE_DEGREE_SIZE_L00_L03, &L00_L03_topLeftLon, &L00_L03_topLeftLat);
-    qDebug() << "L04_L08 to L00_L03:  " << QString::number(L00_L03_topLeftLon, 'f', 2) << "  "
+    LOG_INFO << "L04_L08 to L00_L03:  " << QString::number(L00_L03_topLeftLon, 'f', 2) << "  "
                                         << QString::number(L00_L03_topLeftLat, 'f', 2) << "  "
                                         << L00_L03_index;
 
@@ -547,31 +684,39 @@ void CResizer::buildL00_L03TerrainFromL04_L08(int L00_L03_index)
     cacheManager.convertTopLeft2AvabilityIndex(L00_L03_topLeftLon, L00_L03_topLeftLat, HGT_SOURCE_DEGREE_SIZE_L04_L08, &L04_L08_index);
 
     // get filenames of data in upper level
+    CScopedTimer findTimer("find");
     hasAtLeastOneL04_L08 = false;
     for (y=0; y<4; y++)
         for (x=0; x<4; x++) {
             index = cacheManager.getNeighborAvabilityIndex(L04_L08_index, HGT_SOURCE_DEGREE_SIZE_L04_L08, x, y);
 
-            hgtFilename[y*4 + x] = "";
+            hgtAvability[y*4 + x] = 0;
             if (index!=-1)
                 if (cacheManager.avability_L04_L08[index].available) {
-                    hgtFilename[y*4 + x] = (*cacheManager.avability_L04_L08[index].name);
+                    hgtAvability[y*4 + x] = &cacheManager.avability_L04_L08[index];
                     hasAtLeastOneL04_L08 = true;
                 }
         }
+    findTimer.stop();
 
 
     // if files was found copy data to lower LOD
     if (hasAtLeastOneL04_L08) {
 
-        qDebug() << "    Copy data with skipping...";
+        LOG_INFO << "    Copy data with skipping...";
+        CScopedTimer decimateTimer("decimate");
         hgt_L00_L03.init(65, 65);
+        lodData.init(HGT_SOURCE_L00_L03);
         for (y=0; y<4; y++)
             for (x=0; x<4; x++) {
 
-                if (hgtFilename[y*4 + x]!="") {
-                    hgt_L04_L08.loadFile(cacheManager.pathL04_L08 + hgtFilename[y*4 + x], 513, 513);
+                if (hgtAvability[y*4 + x]!=0) {
+                    // only rows used by decimation and LOD error are decoded
+                    hgt_L04_L08.loadTile(hgtAvability[y*4 + x], cacheManager.pathL04_L08, 513, 513,
+                                         cacheManager.HGTsourceSkippingLookUp[4]);
                     hgt_L04_L08.getHeightBlock(buffer, 0, 0, 17, 17, 32);
+                    // LOD 3 error against LOD 4 while L04_L08 tile is loaded
+                    lodData.accumulateError(3, &hgt_L04_L08, cacheManager.HGTsourceSkippingLookUp[4], x*2, y*2, 2);
                 } else {
                     for (i=0; i<17*17; i++)
                         buffer[i] = 0;
@@ -580,19 +725,67 @@ void CResizer::buildL00_L03TerrainFromL04_L08(int L00_L03_index)
                 hgt_L00_L03.setHeightBlock(buffer, x*16, y*16, 17, 17, 1);
             }
 
+        decimateTimer.stop();
+
         cacheManager.convertLonLatToFileName(L00_L03_topLeftLon, L00_L03_topLeftLat, &hgtFilenameResult);
-        hgt_L00_L03.saveFile(cacheManager.pathL00_L03 + hgtFilenameResult);
-        qDebug() << "    Copy data with skipping... OK";
+        if ( ! saveFileWithStats(&hgt_L00_L03, HGT_SOURCE_L00_L03, cacheManager.pathL00_L03 + hgtFilenameResult,
+                                 &lodData, L00_L03_topLeftLat)) {
+            LOG_ERROR << "    Copy data with skipping... save failed";
+            delete []buffer;
+            return false;
+        }
+        LOG_INFO << "    Copy data with skipping... OK";
+        CRunReport::getInstance()->count("tilesProcessed");
 
     } else {
 
-        qDebug() << "    No terrain in upper level... skipping";
+        LOG_INFO << "    No terrain in upper level... skipping";
+        CRunReport::getInstance()->count("tilesSkipped");
         delete []buffer;
-        return;
+        return true;
 
     }
 
     delete []buffer;
+    return true;
+}
+
+bool CResizer::saveFileWithStats(CHgtFile *hgt, int hgtSource, const QString &filename, CLodData *lodData, double tlLat)
+{
+    CScopedTimer saveTimer("save");
+
+    // lossy levels are quantized first, so statistics, normals and LOD
+    // errors describe stored heights
+    if (hgtSource<=HGT_SOURCE_L09_L13) {
+        hgt->quantize(lossyMaxError[hgtSource]);
+        lodData->addQuantizationError(lossyMaxError[hgtSource]);
+    }
+    lodData->compute(hgt, tlLat);
+
+    // L09_L13 stays raw until stitched, connect seeks edges in place and
+    // rebuildL09_L13Sidecars stores it encoded afterwards
+    if (hgtSource==HGT_SOURCE_L09_L13)
+        hgt->setSaveRaw(true);
+
+    // statistics first - saveFile leaves data in big endian order
+    if ( ! saveSidecars(hgt, hgtSource, filename, lodData)) return false;
+    return hgt->saveFile(filename);
+}
+
+bool CResizer::saveSidecars(CHgtFile *hgt, int hgtSource, const QString &filename, CLodData *lodData)
+{
+    CTileStats stats;
+    CMinMaxTree minMaxTree;
+    bool saved;
+
+    stats.compute(hgt, hgtSource);
+    saved = stats.saveFile(CTileStats::getFileName(filename));
+    if (hgtSource==HGT_SOURCE_L09_L13) {
+        minMaxTree.build(hgt);
+        saved = minMaxTree.saveFile(CMinMaxTree::getFileName(filename)) && saved;
+    }
+    saved = lodData->saveFile(CLodData::getFileName(filename)) && saved;
+    return saved;
 }
 
 unsigned int CResizer::getColor(int height)
@@ -628,10 +821,28 @@ unsigned int CResizer::getColor(int height)
     return qRgb(r, g, b);
 }
 
-void CResizer::generateHtmlIndex(int hgtSource, bool createImages, double lon = -1.0, double lat = -1.0)
+void CResizer::colorizeImage(CHgtFile *hgt, QImage *image)
+{
+    colorizeImage(hgt->getHeightBuffer(), hgt->getSizeX(), hgt->getSizeY(), image);
+}
+
+void CResizer::colorizeImage(quint16 *buffer, int sx, int sy, QImage *image)
+{
+    quint16 *row;
+    QRgb *line;
+    int x, y;
+
+    // whole rows at once - gather from look-up table straight into image memory
+    for (y=0; y<sy; y++) {
+        row = buffer + y*sx;
+        line = (QRgb *)image->scanLine(y);
+        for (x=0; x<sx; x++)
+            line[x] = colorLookUp[row[x]];
+    }
+}
+
+void CResizer::generateHtmlIndex(int hgtSource, bool createImages, double lon = -1.0, double lat = -1.0, bool thumbnailsOnly)
 {
-    CHgtFile hgtFile;
-    QImage imageTH;
     QString filename;
     fstream fileHTML;
     double tlLon, tlLat;
@@ -709,38 +920,32 @@ void CResizer::generateHtmlIndex(int hgtSource, bool createImages, double lon =
                                  break;
     }
 
-    QImage image(hgtSourceSize, hgtSourceSize, QImage::Format_RGB32);
-
-
     if (createImages) {
-        for (index=0; index<earthSizeX*earthSizeY; index++) {
-
-            if (onePhoto) {
-                index = onePhotoIndex;
-            }
-
-            if (avab[index].available) {
-                cacheManager.convertAvabilityIndex2TopLeft(index, hgtSourceDegree, &tlLon, &tlLat);
-                qDebug() << info << " index " << QString::number(tlLon, 'f', 2) << " " << QString::number(tlLat, 'f', 2) << " " << index;
-                qDebug() << "    Create img...";
-                hgtFile.loadFile(pathDir + (*avab[index].name), hgtSourceSize, hgtSourceSize);
-                for (y=0; y<hgtSourceSize; y++)
-                    for (x=0; x<hgtSourceSize; x++) {
-                        image.setPixel(x, y, getColor(hgtFile.getHeight(x, y)));
-                    }
-                cacheManager.convertLonLatToFileName(tlLon, tlLat, &filename);
-                image.save(pathDirIndex + filename + ".jpg", 0, 90);
-                imageTH = image.scaledToWidth(THsize, Qt::SmoothTransformation);
-                imageTH.save(pathDirIndex + filename + "_th.jpg", 0, 90);
-                qDebug() << "    Create img... OK";
-            }
-
-            if (onePhoto)
-                break;
+        // load & color and encode tiles in parallel
+        CIndexImagePipeline pipeline(this);
+        QList<int> indexes;
+
+        if (onePhoto) {
+            indexes.append(onePhotoIndex);
+        } else {
+            for (index=0; index<earthSizeX*earthSizeY; index++)
+                if (avab[index].available)
+                    indexes.append(index);
         }
+
+        pipeline.avab = avab;
+        pipeline.hgtSource = hgtSource;
+        pipeline.thumbnailsOnly = thumbnailsOnly;
+        pipeline.hgtSourceDegree = hgtSourceDegree;
+        pipeline.hgtSourceSize = hgtSourceSize;
+        pipeline.itemMemory = (qint64)hgtSourceSize*hgtSourceSize*MEMORY_JOB_INDEX_IMAGE_SAMPLE;
+        pipeline.THsize = (int)THsize;
+        pipeline.pathDir = pathDir;
+        pipeline.pathDirIndex = pathDirIndex;
+        pipeline.run(indexes, info);
     }
 
-    qDebug() << info << " HTML index...";
+    LOG_INFO << info << " HTML index...";
     fileHTML.open(QString(pathDirIndex + "!_index.html").toAscii(), fstream::out);
     fileHTML << "<html><head><title></title>";
     fileHTML << "<style type=\"text/css\"> div > a { display: block; position: absolute; width: "
@@ -773,5 +978,5 @@ void CResizer::generateHtmlIndex(int hgtSource, bool createImages, double lon =
     fileHTML << "</div>";
     fileHTML << "</body></html>";
     fileHTML.close();
-    qDebug() << info << " HTML index... OK";
+    LOG_INFO << info << " HTML index... OK";
 }
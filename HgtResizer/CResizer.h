@@ -39,33 +39,50 @@
 #define CRESIZER_H
 
 #include "CCacheManager.h"
+#include <QImage>
+#include "CHgtFile.h"
+
+class CLodData;
 
 class CResizer
 {
 public:
     CCacheManager cacheManager;
+    int threadCount;
+    int tileThreadCount;              // threads inside one tile, 0 = threadCount, 1 when tiles run in parallel
+    int lossyMaxError[3];             // per HGT source L00-L03..L09-L13 in metres, 0 = lossless
 
     CResizer();
+    ~CResizer();
     void buildL09_L13TerrainFromSRTMEntireEarth();
     void buildL09_L13TerrainFromSRTM(const double &lon, const double &lat);
-    void buildL09_L13TerrainFromSRTM(int L09_L13_index);
+    bool buildL09_L13TerrainFromSRTM(int L09_L13_index);
 
     void buildL04_L08TerrainFromL09_L13EntireEarth();
     void buildL04_L08TerrainFromL09_L13(const double &lon, const double &lat);
-    void buildL04_L08TerrainFromL09_L13(int L04_L08_index);
+    bool buildL04_L08TerrainFromL09_L13(int L04_L08_index);
 
     void buildL00_L03TerrainFromL04_L08EntireEarth();
     void buildL00_L03TerrainFromL04_L08(const double &lon, const double &lat);
-    void buildL00_L03TerrainFromL04_L08(int L00_L03_index);
+    bool buildL00_L03TerrainFromL04_L08(int L00_L03_index);
 
     void connectL09_L13TerrainEntireEarth();
     void connectL09_L13Terrain(const double &lon, const double &lat);
-    void connectL09_L13Terrain(int L09_L13_index);
+    bool connectL09_L13Terrain(int L09_L13_index);
+    // stitching changes edges of tile and its neighbors after build wrote sidecars
+    bool rebuildL09_L13Sidecars(int L09_L13_index);
 
-    void generateHtmlIndex(int hgtSource, bool createImages, double lon, double lat);
+    void generateHtmlIndex(int hgtSource, bool createImages, double lon, double lat, bool thumbnailsOnly = false);
+    void colorizeImage(CHgtFile *hgt, QImage *image);
+    void colorizeImage(quint16 *buffer, int sx, int sy, QImage *image);
+    QRgb getLookUpColor(int height) { return colorLookUp[height]; }
+    unsigned int getColor(int height);
 
 private:
-    unsigned int getColor(int height);
+    unsigned int *colorLookUp;        // height -> RGB for every possible quint16 height
+
+    bool saveFileWithStats(CHgtFile *hgt, int hgtSource, const QString &filename, CLodData *lodData, double tlLat);
+    bool saveSidecars(CHgtFile *hgt, int hgtSource, const QString &filename, CLodData *lodData);
     bool findSRTMFilesFor_L09_L13(const double &L09_L13_topLeftLon, const double &L09_L13_topLeftLat,
                                   int *SRTMfilesIndex, int *offsetLon, int *offsetLat);
 };
@@ -0,0 +1,162 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include <QTextStream>
+#include <QtAlgorithms>
+#include "CRunReport.h"
+#include "CHgtFile.h"
+#include "CMemoryBudget.h"
+
+CRunReport CRunReport::instance;
+
+CRunReport::CRunReport()
+{
+    task = 0;
+    started = QDateTime::currentDateTime();
+    runTimer.start();
+}
+
+CRunReport *CRunReport::getInstance()
+{
+    return &instance;
+}
+
+void CRunReport::setTask(int t)
+{
+    QMutexLocker locker(&mutex);
+    task = t;
+}
+
+void CRunReport::addStage(const QString &name, int ms, qint64 rss)
+{
+    QMutexLocker locker(&mutex);
+    stages[name].append(ms);
+    stagesRss[name] = qMax(stagesRss.value(name), rss);
+}
+
+void CRunReport::count(const QString &name, qint64 value)
+{
+    QMutexLocker locker(&mutex);
+    counters[name] += value;
+}
+
+qint64 CRunReport::getCount(const QString &name)
+{
+    QMutexLocker locker(&mutex);
+    return counters.value(name);
+}
+
+int CRunReport::percentile(const QList<int> &sorted, int p)
+{
+    int i;
+
+    // nearest rank
+    i = (sorted.size()*p + 99) / 100 - 1;
+    if (i<0) i = 0;
+
+    return sorted.at(i);
+}
+
+bool CRunReport::saveFile(const QString &name)
+{
+    QMutexLocker locker(&mutex);
+    QFile file(name);
+    QMap<QString, QList<int> >::const_iterator it;
+    QMap<QString, qint64>::const_iterator itCounter;
+    CHgtFileCounters io;
+    QList<int> sorted;
+    qint64 total;
+    int i;
+
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+
+    out << "{\n";
+    out << "  \"task\": " << task << ",\n";
+    out << "  \"started\": \"" << started.toString(Qt::ISODate) << "\",\n";
+    out << "  \"wallMs\": " << runTimer.elapsed() << ",\n";
+
+    // per stage totals and percentiles of single run durations
+    out << "  \"stages\": {";
+    for (it=stages.constBegin(); it!=stages.constEnd(); ++it) {
+        sorted = it.value();
+        qSort(sorted);
+        total = 0;
+        for (i=0; i<sorted.size(); i++)
+            total += sorted.at(i);
+
+        out << ((it==stages.constBegin()) ? "\n" : ",\n");
+        out << "    \"" << it.key() << "\": { "
+            << "\"count\": " << sorted.size() << ", "
+            << "\"totalMs\": " << total << ", "
+            << "\"meanMs\": " << QString::number((double)total / sorted.size(), 'f', 1) << ", "
+            << "\"p50Ms\": " << percentile(sorted, 50) << ", "
+            << "\"p90Ms\": " << percentile(sorted, 90) << ", "
+            << "\"p99Ms\": " << percentile(sorted, 99) << ", "
+            << "\"maxMs\": " << sorted.last() << ", "
+            << "\"rssAtEndMB\": " << stagesRss.value(it.key()) / MEMORY_MB << " }";
+    }
+    out << "\n  },\n";
+
+    out << "  \"counters\": {";
+    for (itCounter=counters.constBegin(); itCounter!=counters.constEnd(); ++itCounter) {
+        out << ((itCounter==counters.constBegin()) ? "\n" : ",\n");
+        out << "    \"" << itCounter.key() << "\": " << itCounter.value();
+    }
+    out << "\n  },\n";
+
+    out << "  \"memory\": {\n";
+    out << "    \"limitMB\": " << CMemoryBudget::getInstance()->getLimit() / MEMORY_MB << ",\n";
+    out << "    \"admittedPeakMB\": " << CMemoryBudget::getInstance()->getPeakUsed() / MEMORY_MB << ",\n";
+    out << "    \"peakRssMB\": " << CMemoryBudget::getPeakRss() / MEMORY_MB << "\n";
+    out << "  },\n";
+
+    io = CHgtFile::getCounters();
+    out << "  \"io\": {\n";
+    out << "    \"bytesRead\": " << io.bytesRead << ",\n";
+    out << "    \"bytesWritten\": " << io.bytesWritten << ",\n";
+    out << "    \"seeks\": " << io.seeks << ",\n";
+    out << "    \"fileOpens\": " << io.fileOpens << "\n";
+    out << "  }\n";
+    out << "}\n";
+
+    file.close();
+
+    return true;
+}
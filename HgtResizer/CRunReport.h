@@ -0,0 +1,79 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CRUNREPORT_H
+#define CRUNREPORT_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QTime>
+#include <QDateTime>
+
+#define RUN_REPORT_FILENAME       "run_report.json"
+
+// Collects stage durations and counters of whole run, thread safe. Written
+// as JSON at the end of every run, so throughput can be compared between runs.
+class CRunReport
+{
+public:
+    static CRunReport *getInstance();
+
+    void setTask(int t);
+    void addStage(const QString &name, int ms, qint64 rss = 0);
+    void count(const QString &name, qint64 value = 1);
+    qint64 getCount(const QString &name);
+    bool saveFile(const QString &name);
+
+private:
+    CRunReport();
+
+    static CRunReport instance;
+    QMutex mutex;
+    QTime runTimer;
+    QDateTime started;
+    int task;
+    QMap<QString, QList<int> > stages;        // durations [ms] of each stage run
+    QMap<QString, qint64> stagesRss;          // highest resident memory sampled at end of stage runs,
+                                              // not peak inside stage (see memory.peakRssMB)
+    QMap<QString, qint64> counters;
+
+    static int percentile(const QList<int> &sorted, int p);
+};
+
+#endif // CRUNREPORT_H
@@ -0,0 +1,69 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include "CScopedTimer.h"
+#include "CRunReport.h"
+#include "CTrace.h"
+#include "CMemoryBudget.h"
+
+CScopedTimer::CScopedTimer(const char *stageName)
+{
+    name = stageName;
+    running = true;
+    timer.start();
+    CTrace::begin(name);
+}
+
+CScopedTimer::~CScopedTimer()
+{
+    stop();
+}
+
+int CScopedTimer::stop()
+{
+    int ms;
+
+    if ( ! running) return 0;
+
+    ms = timer.elapsed();
+    running = false;
+    CTrace::end(name);
+    // buffers of stage are still allocated here
+    CRunReport::getInstance()->addStage(QString::fromAscii(name), ms, CMemoryBudget::getRss());
+
+    return ms;
+}
@@ -0,0 +1,248 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtAlgorithms>
+#include <QVector>
+#include "CShardPlanner.h"
+#include "CLog.h"
+
+CShardPlanner::CShardPlanner(CCacheManager *cm, int n, const QString &run)
+{
+    cacheManager = cm;
+    shards = n;
+    runId = run;
+}
+
+int CShardPlanner::getWeight(int hgtSource, int index, bool stitching)
+{
+    CAvability *avab;
+    QList<int> inputs;
+    double degreeSize = cacheManager->getSourceDegreeSize(hgtSource);
+    double tlLon, tlLat;
+    int i, neighbor, weight;
+
+    // stitching opens tile and its available neighbors
+    if (stitching) {
+        if ( ! cacheManager->avability_L09_L13[index].available) return 0;
+        weight = 1;
+        for (i=0; i<9; i++) {
+            neighbor = cacheManager->getNeighborAvabilityIndex(index, degreeSize, i%3 - 1, i/3 - 1);
+            if (i!=4 && neighbor!=-1 && cacheManager->avability_L09_L13[neighbor].available) weight++;
+        }
+        return weight;
+    }
+
+    // building reads input tiles of upper level covering the tile
+    cacheManager->convertAvabilityIndex2TopLeft(index, degreeSize, &tlLon, &tlLat);
+    switch (hgtSource) {
+        case HGT_SOURCE_L09_L13: avab = cacheManager->avability_SRTM;    break;
+        case HGT_SOURCE_L04_L08: avab = cacheManager->avability_L09_L13; break;
+        default:                 avab = cacheManager->avability_L04_L08; break;
+    }
+    inputs = cacheManager->getIndexesInBox((hgtSource==HGT_SOURCE_L09_L13) ? HGT_SOURCE_DEGREE_SIZE_SRTM :
+                                           cacheManager->getSourceDegreeSize(hgtSource + 1),
+                                           tlLon, tlLat - degreeSize, tlLon + degreeSize, tlLat);
+    weight = 0;
+    for (i=0; i<inputs.size(); i++)
+        if (avab[inputs.at(i)].available) weight++;
+
+    return weight;
+}
+
+void CShardPlanner::assign(const QList<int> &indexes, int hgtSource, bool stitching)
+{
+    QList<CShardTile> tiles;
+    CShardTile tile;
+    int tilesX = (int)(360.0 / cacheManager->getSourceDegreeSize(hgtSource) + 0.5);
+    QVector<qint64> columnWeight(tilesX, 0);
+    QVector<int> columnShard(tilesX, 0);
+    qint64 total, sum;
+    int i, s, best, x;
+
+    tileShard.clear();
+    loads.clear();
+    ordered.clear();
+    for (s=0; s<shards; s++)
+        loads.append(0);
+
+    for (i=0; i<indexes.size(); i++) {
+        tile.index = indexes.at(i);
+        tile.weight = getWeight(hgtSource, tile.index, stitching);
+        if (tile.weight>0)
+            tiles.append(tile);
+    }
+    qSort(tiles);
+
+    if (stitching) {
+        // band ends where its columns reach next equal share of total weight
+        total = 0;
+        for (i=0; i<tiles.size(); i++) {
+            columnWeight[tiles.at(i).index % tilesX] += tiles.at(i).weight;
+            total += tiles.at(i).weight;
+        }
+        s = 0;
+        sum = 0;
+        for (x=0; x<tilesX; x++) {
+            columnShard[x] = s;
+            sum += columnWeight.at(x);
+            if (s<shards-1 && sum*shards>=total*(s + 1)) s++;
+        }
+    }
+
+    // build by longest processing time first - heaviest tile to least loaded shard
+    for (i=0; i<tiles.size(); i++) {
+        if (stitching) {
+            best = columnShard.at(tiles.at(i).index % tilesX);
+        } else {
+            best = 0;
+            for (s=1; s<shards; s++)
+                if (loads.at(s)<loads.at(best)) best = s;
+        }
+        tileShard.insert(tiles.at(i).index, best);
+        loads[best] += tiles.at(i).weight;
+        ordered.append(tiles.at(i).index);
+    }
+}
+
+QList<int> CShardPlanner::getTiles(int shard)
+{
+    QList<int> indexes;
+    QMap<int, int>::const_iterator it;
+
+    for (it=tileShard.constBegin(); it!=tileShard.constEnd(); ++it)
+        if (it.value()==shard) indexes.append(it.key());
+
+    return indexes;
+}
+
+bool CShardPlanner::isInterior(int index)
+{
+    int shard = tileShard.value(index);
+    int i, neighbor;
+
+    // stitching changes borders of neighbors, they must not belong to other process
+    for (i=0; i<9; i++) {
+        if (i==4) continue;
+        neighbor = cacheManager->getNeighborAvabilityIndex(index, HGT_SOURCE_DEGREE_SIZE_L09_L13, i%3 - 1, i/3 - 1);
+        if (neighbor==-1 || ! cacheManager->avability_L09_L13[neighbor].available) continue;
+        if ( ! tileShard.contains(neighbor) || tileShard.value(neighbor)!=shard) return false;
+    }
+
+    return true;
+}
+
+QList<int> CShardPlanner::getInteriorTiles(int shard)
+{
+    QList<int> indexes = getTiles(shard);
+    QList<int> interior;
+    int i;
+
+    for (i=0; i<indexes.size(); i++)
+        if (isInterior(indexes.at(i))) interior.append(indexes.at(i));
+
+    return interior;
+}
+
+QList<int> CShardPlanner::getSeamTiles()
+{
+    QList<int> seams;
+    QMap<int, int>::const_iterator it;
+
+    for (it=tileShard.constBegin(); it!=tileShard.constEnd(); ++it)
+        if ( ! isInterior(it.key())) seams.append(it.key());
+
+    return seams;
+}
+
+QString CShardPlanner::getMarkerName(const QString &task, int hgtSource, int shard)
+{
+    return cacheManager->pathBase + SHARD_MARKER_DIR + runId + "_" + task + "_" + QString::number(hgtSource) + "_" +
+           QString::number(shard) + "_of_" + QString::number(shards) + ".done";
+}
+
+void CShardPlanner::writeMarker(const QString &task, int hgtSource, int shard, int tiles)
+{
+    QFile file(getMarkerName(task, hgtSource, shard));
+
+    QDir().mkpath(cacheManager->pathBase + SHARD_MARKER_DIR);
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        LOG_ERROR << "Can't write shard marker" << file.fileName();
+        return;
+    }
+    QTextStream out(&file);
+    out << tiles << " tiles, load " << loads.at(shard) << ", " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    file.close();
+}
+
+void CShardPlanner::removeMarker(const QString &task, int hgtSource, int shard)
+{
+    QFile::remove(getMarkerName(task, hgtSource, shard));
+}
+
+bool CShardPlanner::waitForMarkers(const QString &task, int hgtSource, int timeout)
+{
+    QMutex mutex;
+    QWaitCondition sleep;
+    QDateTime deadline = QDateTime::currentDateTime().addSecs(timeout);
+    int s, missing;
+
+    mutex.lock();
+    while (true) {
+        missing = 0;
+        for (s=0; s<shards; s++)
+            if ( ! QFile::exists(getMarkerName(task, hgtSource, s))) missing++;
+        if (missing==0) break;
+
+        // crashed shard never writes its marker
+        if (timeout>0 && QDateTime::currentDateTime()>=deadline) {
+            LOG_ERROR << "Timeout waiting for" << missing << "of" << shards << "shards:" << task << hgtSource;
+            mutex.unlock();
+            return false;
+        }
+        LOG_INFO << "Waiting for" << missing << "of" << shards << "shards:" << task << hgtSource;
+        sleep.wait(&mutex, SHARD_POLL_INTERVAL);
+    }
+    mutex.unlock();
+
+    return true;
+}
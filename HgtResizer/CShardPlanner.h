@@ -0,0 +1,97 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CSHARDPLANNER_H
+#define CSHARDPLANNER_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include "CCacheManager.h"
+
+#define SHARD_MARKER_DIR          "shards\\"
+#define SHARD_POLL_INTERVAL       10000     // [ms] between checks of other shards markers
+
+class CShardTile
+{
+public:
+    int index;
+    int weight;
+
+    // heaviest first, index keeps order deterministic
+    bool operator<(const CShardTile &t) const { return weight>t.weight || (weight==t.weight && index<t.index); }
+};
+
+// Deterministic tile to shard assignment shared by all processes of sharded
+// run. Work of tile is estimated from availability of its input tiles (SRTM
+// tiles exist only for land), tiles without input are not assigned at all.
+// Builds are balanced by longest processing time first. Stitching gets
+// contiguous longitude bands of about equal weight, so only tiles next to
+// band borders are seams left for merge. Processes coordinate only by done
+// markers in output root, named by run id so markers of earlier runs are
+// never taken for this one.
+class CShardPlanner
+{
+public:
+    CShardPlanner(CCacheManager *cm, int n, const QString &run);
+
+    void assign(const QList<int> &indexes, int hgtSource, bool stitching);
+    QList<int> getTiles(int shard);
+    QList<int> getInteriorTiles(int shard);     // all neighbors in same shard, stitched by shard itself
+    QList<int> getSeamTiles();                  // stitched by merge after all shards
+    QList<int> getTilesByWeight() { return ordered; }   // all assigned tiles, heaviest first
+    qint64 getLoad(int shard) { return loads.at(shard); }
+
+    QString getMarkerName(const QString &task, int hgtSource, int shard);
+    void writeMarker(const QString &task, int hgtSource, int shard, int tiles);
+    void removeMarker(const QString &task, int hgtSource, int shard);
+    // false when timeout [s] passed first, 0 waits without limit
+    bool waitForMarkers(const QString &task, int hgtSource, int timeout);
+
+private:
+    CCacheManager *cacheManager;
+    int shards;
+    QString runId;
+    QMap<int, int> tileShard;                   // tile index -> shard
+    QList<qint64> loads;
+    QList<int> ordered;
+
+    int getWeight(int hgtSource, int index, bool stitching);
+    bool isInterior(int index);
+};
+
+#endif // CSHARDPLANNER_H
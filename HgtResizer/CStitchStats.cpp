@@ -0,0 +1,131 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include <QTextStream>
+#include "CStitchStats.h"
+#include "CLog.h"
+
+CStitchStats::CStitchStats()
+{
+    reset();
+}
+
+void CStitchStats::reset()
+{
+    int i;
+
+    for (i=0; i<STITCH_STATS_EDGES; i++) {
+        edges[i].samples = 0;
+        edges[i].mismatches = 0;
+        edges[i].maxDelta = 0;
+        edges[i].sumDelta = 0;
+    }
+}
+
+const char *CStitchStats::getEdgeName(int edge)
+{
+    static const char *names[STITCH_STATS_EDGES] = { "N", "S", "W", "E", "NW", "NE", "SW", "SE" };
+
+    return names[edge];
+}
+
+void CStitchStats::check(CHgtFile *hgt, int x, int y, int height, int edge, const char *tileName, bool save)
+{
+    CStitchEdge *e = &edges[edge];
+    int current, delta;
+
+    e->samples++;
+    current = hgt->fileGetHeight(x, y);
+    if (current==height) return;
+
+    delta = qAbs(current - height);
+    e->mismatches++;
+    e->sumDelta += delta;
+    if (delta>e->maxDelta) e->maxDelta = delta;
+
+    LOG_DEBUG << "[" << getEdgeName(edge) << x << y << "]" << tileName << ":" << current << "!=" << height;
+    if (save) hgt->fileSetHeight(x, y, height);
+}
+
+int CStitchStats::getMismatches()
+{
+    int i, sum;
+
+    sum = 0;
+    for (i=0; i<STITCH_STATS_EDGES; i++)
+        sum += edges[i].mismatches;
+
+    return sum;
+}
+
+int CStitchStats::getMaxDelta()
+{
+    int i, maxDelta;
+
+    maxDelta = 0;
+    for (i=0; i<STITCH_STATS_EDGES; i++)
+        maxDelta = qMax(maxDelta, edges[i].maxDelta);
+
+    return maxDelta;
+}
+
+bool CStitchStats::appendFile(const QString &name, int index, double lon, double lat)
+{
+    QFile file(name);
+    bool header;
+    int i;
+
+    // one row per edge of stitched tile, header only in new file
+    header = ( ! file.exists() || file.size()==0);
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+
+    if (header)
+        out << "index,lon,lat,edge,samples,mismatches,maxDelta,meanDelta\n";
+    for (i=0; i<STITCH_STATS_EDGES; i++) {
+        if (edges[i].samples==0) continue;
+        out << index << "," << QString::number(lon, 'f', 2) << "," << QString::number(lat, 'f', 2) << ","
+            << getEdgeName(i) << "," << edges[i].samples << "," << edges[i].mismatches << "," << edges[i].maxDelta << ","
+            << QString::number((edges[i].mismatches>0) ? (double)edges[i].sumDelta / edges[i].mismatches : 0.0, 'f', 2) << "\n";
+    }
+
+    file.close();
+
+    return true;
+}
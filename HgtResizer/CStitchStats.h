@@ -0,0 +1,77 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CSTITCHSTATS_H
+#define CSTITCHSTATS_H
+
+#include <QString>
+#include "CHgtFile.h"
+
+#define STITCH_STATS_FILENAME     "stitch_edges.csv"
+#define STITCH_STATS_EDGES        8
+
+class CStitchEdge
+{
+public:
+    int samples;           // border samples compared, of all tiles sharing edge
+    int mismatches;
+    int maxDelta;
+    qint64 sumDelta;
+};
+
+// Per edge aggregates of border samples changed by stitching of one tile.
+// Single samples are logged only at LOG_LEVEL_DEBUG.
+class CStitchStats
+{
+public:
+    enum { EDGE_N, EDGE_S, EDGE_W, EDGE_E, CORNER_NW, CORNER_NE, CORNER_SW, CORNER_SE };
+
+    CStitchEdge edges[STITCH_STATS_EDGES];
+
+    CStitchStats();
+
+    void reset();
+    // compares file mode sample with stitched height, optionally sets it
+    void check(CHgtFile *hgt, int x, int y, int height, int edge, const char *tileName, bool save);
+    int getMismatches();
+    int getMaxDelta();
+    bool appendFile(const QString &name, int index, double lon, double lat);
+
+    static const char *getEdgeName(int edge);
+};
+
+#endif // CSTITCHSTATS_H
@@ -0,0 +1,652 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <iostream>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMap>
+#include <QRegExp>
+#include "CTaskRunner.h"
+#include "CResizer.h"
+#include "CTileExporter.h"
+#include "CReliefRenderer.h"
+#include "CHgtArchive.h"
+#include "CHgtFile.h"
+#include "CHgtCodec.h"
+#include "CRunReport.h"
+#include "CLog.h"
+#include "CShardPlanner.h"
+#include "CJournal.h"
+#include "CWorkQueue.h"
+#include "CMemoryBudget.h"
+#include "CMinMaxTree.h"
+
+using namespace std;
+
+// Tile of parallel build, its memory is admitted by dispatcher
+class CTaskJob : public QRunnable
+{
+public:
+    CTaskJob(CTaskRunner *r, int src, int i, const QString &name, CJournal *j, qint64 m)
+        { runner = r; hgtSource = src; index = i; outputName = name; journal = j; memory = m; }
+    void run()
+        { runner->runJob(hgtSource, index, outputName, journal); CMemoryBudget::getInstance()->release(memory); }
+
+private:
+    CTaskRunner *runner;
+    int hgtSource;
+    int index;
+    QString outputName;
+    CJournal *journal;
+    qint64 memory;
+};
+
+CTaskRunner::CTaskRunner(CResizer *r)
+{
+    resizer = r;
+    task = TASK_NONE;
+    hasBox = false;
+    minLon = 0.0;
+    minLat = -90.0;
+    maxLon = 360.0;
+    maxLat = 90.0;
+    threads = 0;
+    waitTimeout = 0;
+    maxError = 0;
+    encoding = HGT_ENCODING_RAW;
+    minZoom = 0;
+    maxZoom = 8;
+    dryRun = false;
+    shard = -1;
+    shards = 0;
+    resume = false;
+    memoryLimit = 0;
+}
+
+void CTaskRunner::printUsage()
+{
+    cout << "Usage: HgtResizer --task <name> [options]" << endl;
+    cout << "  --task build|connect|merge|sidecars|index|export|relief|pack|unpack" << endl;
+    cout << "  --level L09_L13,L04_L08,...   levels in processing order (L00_L03, L04_L08, L09_L13, SRTM)" << endl;
+    cout << "  --bbox minLon,minLat,maxLon,maxLat   only tiles intersecting box (build, connect)" << endl;
+    cout << "  --threads <n>                 worker threads" << endl;
+    cout << "  --input <dir>                 root of NASA_SRTM and SRTM_sources.txt" << endl;
+    cout << "  --output <dir>                root of level and index directories" << endl;
+    cout << "  --encoding raw|sparse|delta|auto   format of written tiles, default raw" << endl;
+    cout << "  --max-error <m>               lossy encoding of built L04_L08/L00_L03 tiles" << endl;
+    cout << "  --zoom <min>,<max>            zoom levels of export, default 0,8" << endl;
+    cout << "  --shard <k>/<n>               k-th of n processes of build or connect, from 0" << endl;
+    cout << "  --shards <n>                  merge after sharded connect of n processes" << endl;
+    cout << "  --run-id <id>                 name of run shared by its processes, needed by --shard, --shards, --queue" << endl;
+    cout << "  --wait-timeout <s>            give up waiting for other shards, default no limit" << endl;
+    cout << "  --queue <dir>                 claim tiles from queue shared by processes, whole level tasks as one job" << endl;
+    cout << "                                jobs done in run are skipped when it is started again with its run id" << endl;
+    cout << "  --memory-limit <MB>           build tiles in parallel while their estimated memory fits" << endl;
+    cout << "  --resume                      skip tiles completed by interrupted run (build, connect, merge)" << endl;
+    cout << "  --dry-run                     list tiles, do not process them" << endl;
+    cout << "  --trace, --debug, --quiet" << endl;
+    cout << "Without --task interactive menu is shown." << endl;
+}
+
+bool CTaskRunner::parseTask(const QString &value)
+{
+    if (value=="build")   task = TASK_BUILD;   else
+    if (value=="connect") task = TASK_CONNECT; else
+    if (value=="index")   task = TASK_INDEX;   else
+    if (value=="export")  task = TASK_EXPORT;  else
+    if (value=="relief")  task = TASK_RELIEF;  else
+    if (value=="pack")    task = TASK_PACK;    else
+    if (value=="unpack")  task = TASK_UNPACK;  else
+    if (value=="merge")   task = TASK_MERGE;   else
+    if (value=="sidecars") task = TASK_SIDECARS; else
+        return false;
+
+    return true;
+}
+
+bool CTaskRunner::parseLevels(const QString &value)
+{
+    QStringList names = value.split(',', QString::SkipEmptyParts);
+    int i;
+
+    hgtSources.clear();
+    for (i=0; i<names.size(); i++) {
+        if (names.at(i)=="L00_L03" || names.at(i)=="0")  hgtSources.append(HGT_SOURCE_L00_L03); else
+        if (names.at(i)=="L04_L08" || names.at(i)=="1")  hgtSources.append(HGT_SOURCE_L04_L08); else
+        if (names.at(i)=="L09_L13" || names.at(i)=="2")  hgtSources.append(HGT_SOURCE_L09_L13); else
+        if (names.at(i)=="SRTM"    || names.at(i)=="10") hgtSources.append(HGT_SOURCE_SRTM);    else
+            return false;
+    }
+
+    return ! hgtSources.isEmpty();
+}
+
+bool CTaskRunner::parseBox(const QString &value)
+{
+    QStringList fields = value.split(',');
+    bool ok[4];
+
+    if (fields.size()!=4) return false;
+    minLon = fields.at(0).toDouble(&ok[0]);
+    minLat = fields.at(1).toDouble(&ok[1]);
+    maxLon = fields.at(2).toDouble(&ok[2]);
+    maxLat = fields.at(3).toDouble(&ok[3]);
+    hasBox = true;
+
+    return ok[0] && ok[1] && ok[2] && ok[3] && minLat<maxLat && minLat>=-90.0 && maxLat<=90.0;
+}
+
+bool CTaskRunner::parseZoom(const QString &value)
+{
+    QStringList fields = value.split(',');
+    bool ok[2];
+
+    if (fields.size()!=2) return false;
+    minZoom = fields.at(0).toInt(&ok[0]);
+    maxZoom = fields.at(1).toInt(&ok[1]);
+
+    return ok[0] && ok[1] && minZoom>=0 && minZoom<=maxZoom && maxZoom<=TILE_EXPORTER_MAX_ZOOM;
+}
+
+bool CTaskRunner::parseShard(const QString &value)
+{
+    QStringList fields = value.split('/');
+    bool ok[2];
+
+    if (fields.size()!=2) return false;
+    shard = fields.at(0).toInt(&ok[0]);
+    shards = fields.at(1).toInt(&ok[1]);
+
+    return ok[0] && ok[1] && shard>=0 && shard<shards;
+}
+
+bool CTaskRunner::parseEncoding(const QString &value)
+{
+    if (value=="raw")    encoding = HGT_ENCODING_RAW;    else
+    if (value=="sparse") encoding = HGT_ENCODING_SPARSE; else
+    if (value=="delta")  encoding = HGT_ENCODING_DELTA;  else
+    if (value=="auto")   encoding = HGT_ENCODING_AUTO;   else
+        return false;
+
+    return true;
+}
+
+bool CTaskRunner::parseArguments(const QStringList &args)
+{
+    QString arg, value;
+    bool ok;
+    int i;
+
+    for (i=1; i<args.size(); i++) {
+        arg = args.at(i);
+        // logging and tracing are set up by main
+        if (arg=="--trace" || arg=="--debug" || arg=="--quiet") continue;
+        if (arg=="--dry-run") {
+            dryRun = true;
+            continue;
+        }
+        if (arg=="--resume") {
+            resume = true;
+            continue;
+        }
+        if (arg=="--help") return false;
+
+        if (i+1>=args.size()) {
+            cout << "Missing value of " << arg.toAscii().data() << endl;
+            return false;
+        }
+        value = args.at(++i);
+
+        ok = true;
+        if (arg=="--task")      ok = parseTask(value);                        else
+        if (arg=="--level")     ok = parseLevels(value);                      else
+        if (arg=="--bbox")      ok = parseBox(value);                         else
+        if (arg=="--threads")   { threads = value.toInt(&ok); ok = ok && threads>0; } else
+        if (arg=="--zoom")      ok = parseZoom(value);                        else
+        if (arg=="--shard")     ok = parseShard(value);                       else
+        if (arg=="--shards")    { shards = value.toInt(&ok); ok = ok && shards>0; } else
+        if (arg=="--queue")     queueDir = value;                             else
+        if (arg=="--run-id")    { runId = value; ok = QRegExp("[A-Za-z0-9_-]+").exactMatch(runId); } else
+        if (arg=="--wait-timeout") { waitTimeout = value.toInt(&ok); ok = ok && waitTimeout>0; } else
+        if (arg=="--memory-limit") { memoryLimit = value.toLongLong(&ok) * MEMORY_MB; ok = ok && memoryLimit>0; } else
+        if (arg=="--input")     inputRoot = value;                            else
+        if (arg=="--output")    outputRoot = value;                           else
+        if (arg=="--encoding")  ok = parseEncoding(value);                    else
+        if (arg=="--max-error") { maxError = value.toInt(&ok); ok = ok && maxError>=0 && maxError<=HGT_CODEC_MAX_ERROR; } else
+            ok = false;
+
+        if ( ! ok) {
+            cout << "Invalid option " << arg.toAscii().data() << " " << value.toAscii().data() << endl;
+            return false;
+        }
+    }
+
+    if (task==TASK_NONE) {
+        cout << "Missing --task" << endl;
+        return false;
+    }
+
+    // default levels and levels each task can work with
+    if (hgtSources.isEmpty())
+        hgtSources.append((task==TASK_BUILD || task==TASK_CONNECT || task==TASK_MERGE || task==TASK_SIDECARS ||
+                           task==TASK_PACK || task==TASK_UNPACK) ?
+                          HGT_SOURCE_L09_L13 : HGT_SOURCE_L04_L08);
+    for (i=0; i<hgtSources.size(); i++) {
+        if ((task==TASK_CONNECT || task==TASK_MERGE || task==TASK_SIDECARS) && hgtSources.at(i)!=HGT_SOURCE_L09_L13) ok = false;
+        if ((task==TASK_BUILD || task==TASK_PACK || task==TASK_UNPACK) && hgtSources.at(i)==HGT_SOURCE_SRTM) ok = false;
+    }
+    if ( ! ok) {
+        cout << "Level can't be used with this task" << endl;
+        return false;
+    }
+    if ((shards>0 && task!=TASK_BUILD && task!=TASK_CONNECT && task!=TASK_MERGE && task!=TASK_SIDECARS) ||
+        (task==TASK_MERGE && shards==0) || (task!=TASK_MERGE && shards>0 && shard<0)) {
+        cout << "Use --shard k/N with build, connect or sidecars, --shards N with merge" << endl;
+        return false;
+    }
+    if (shards>0 && runId.isEmpty()) {
+        // markers of earlier sharded run would release waiting shards too early
+        cout << "Use --run-id with --shard and --shards, the same one in all processes of run" << endl;
+        return false;
+    }
+    if ( ! queueDir.isEmpty() && (task==TASK_MERGE || shards>0)) {
+        // queued connect stitches seams too, nothing is left for merge
+        cout << "Use --queue without --shard, --shards and merge" << endl;
+        return false;
+    }
+    if ( ! queueDir.isEmpty() && runId.isEmpty()) {
+        // done files of earlier run would skip its jobs
+        cout << "Use --run-id with --queue, the same one in all processes of run" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+QString CTaskRunner::getLevelName(int hgtSource)
+{
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: return "L00_L03";
+        case HGT_SOURCE_L04_L08: return "L04_L08";
+        case HGT_SOURCE_L09_L13: return "L09_L13";
+    }
+    return "SRTM";
+}
+
+QString CTaskRunner::getTaskName(int t)
+{
+    switch (t) {
+        case TASK_BUILD:   return "build";
+        case TASK_CONNECT: return "connect";
+        case TASK_MERGE:   return "merge";
+        case TASK_SIDECARS: return "sidecars";
+        case TASK_INDEX:   return "index";
+        case TASK_EXPORT:  return "export";
+        case TASK_RELIEF:  return "relief";
+        case TASK_PACK:    return "pack";
+        case TASK_UNPACK:  return "unpack";
+    }
+    return QString::number(t);
+}
+
+QString CTaskRunner::getTileName(int hgtSource, int index)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    QString name;
+    double tlLon, tlLat;
+
+    cacheManager->convertAvabilityIndex2TopLeft(index, cacheManager->getSourceDegreeSize(hgtSource), &tlLon, &tlLat);
+    cacheManager->convertLonLatToFileName(tlLon, tlLat, &name);
+
+    return cacheManager->getPath(hgtSource) + name;
+}
+
+QString CTaskRunner::getOutputName(int hgtSource, int index)
+{
+    if (task==TASK_SIDECARS)
+        return CMinMaxTree::getFileName(getTileName(hgtSource, index));
+
+    return getTileName(hgtSource, index);
+}
+
+QList<int> CTaskRunner::addNeighbors(const QList<int> &indexes)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    QMap<int, bool> tiles;
+    int i, j, neighbor;
+
+    // stitching of box changes edges of tiles around it too
+    for (i=0; i<indexes.size(); i++)
+        for (j=0; j<9; j++) {
+            neighbor = cacheManager->getNeighborAvabilityIndex(indexes.at(i), HGT_SOURCE_DEGREE_SIZE_L09_L13, j%3 - 1, j/3 - 1);
+            if (neighbor!=-1)
+                tiles.insert(neighbor, true);
+        }
+
+    return tiles.keys();
+}
+
+QList<int> CTaskRunner::getTileIndexes(int hgtSource)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+
+    return cacheManager->getIndexesInBox(cacheManager->getSourceDegreeSize(hgtSource), minLon, minLat, maxLon, maxLat);
+}
+
+bool CTaskRunner::run()
+{
+    CShardPlanner *planner = 0;
+    CJournal *journal = 0;
+    QString journalName;
+    bool ok = true;
+    int i;
+
+    if ( ! inputRoot.isEmpty() || ! outputRoot.isEmpty()) {
+        resizer->cacheManager.setupPaths(inputRoot, outputRoot);
+        resizer->cacheManager.setupAvabilityTables();
+    }
+    if (threads>0)
+        resizer->threadCount = threads;
+    CHgtFile::saveEncoding = encoding;
+    resizer->lossyMaxError[HGT_SOURCE_L04_L08] = maxError;
+    resizer->lossyMaxError[HGT_SOURCE_L00_L03] = maxError;
+    CMemoryBudget::getInstance()->setLimit(memoryLimit);
+
+    if (shards>0) {
+        planner = new CShardPlanner(&resizer->cacheManager, shards, runId);
+        // markers of previous run of this process would release other shards too early
+        if (task!=TASK_MERGE && ! dryRun)
+            for (i=0; i<hgtSources.size(); i++)
+                planner->removeMarker(getTaskName(task), hgtSources.at(i), shard);
+    }
+
+    // each process of sharded run has its own journal, done files of queue
+    // are journal of all processes
+    if ((task==TASK_BUILD || task==TASK_CONNECT || task==TASK_MERGE || task==TASK_SIDECARS) && queueDir.isEmpty() && ! dryRun) {
+        journalName = resizer->cacheManager.pathBase + JOURNAL_FILENAME;
+        if (shards>0)
+            journalName += "." + getTaskName(task) + "_" + QString::number(qMax(shard, 0)) + "_of_" + QString::number(shards);
+        if ( ! resume)
+            QFile::remove(journalName);
+        journal = new CJournal();
+        if ( ! journal->open(journalName))
+            LOG_ERROR << "Can't open journal" << journalName;
+        if (resume) {
+            LOG_INFO << "Resuming," << journal->getCount() << "tiles in journal" << journalName;
+        }
+    }
+
+    CRunReport::getInstance()->setTask(task);
+    for (i=0; i<hgtSources.size(); i++) {
+        // tiles built by previous level have to be visible for next one,
+        // in sharded run also tiles built by other processes
+        if (i>0 && ! dryRun) {
+            if (planner!=0 && ! planner->waitForMarkers(getTaskName(task), hgtSources.at(i-1), waitTimeout)) {
+                ok = false;
+                break;
+            }
+            resizer->cacheManager.setupAvabilityTables();
+        }
+        if ( ! runLevel(hgtSources.at(i), planner, journal)) {
+            ok = false;
+            break;
+        }
+    }
+
+    // sidecars written by build don't describe stitched edges, other
+    // processes of sharded or queued connect could still be stitching
+    if (task==TASK_CONNECT && planner==0 && queueDir.isEmpty()) {
+        task = TASK_SIDECARS;
+        runLevel(HGT_SOURCE_L09_L13, 0, journal);
+        task = TASK_CONNECT;
+    }
+
+    if (planner!=0)
+        delete planner;
+    if (journal!=0)
+        delete journal;
+
+    // scripts driving batch runs see failure in exit code
+    return ok && CRunReport::getInstance()->getCount("tilesFailed")==0 &&
+           CRunReport::getInstance()->getCount("levelsFailed")==0;
+}
+
+bool CTaskRunner::runLevel(int hgtSource, CShardPlanner *planner, CJournal *journal)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    QThreadPool pool;
+    QList<int> indexes;
+    QString outputName;
+    double tlLon, tlLat;
+    qint64 jobMemory;
+    bool parallel;
+    int i;
+
+    // whole level tasks, bounding box is not used
+    if (isWholeLevelTask()) {
+        LOG_INFO << "Task" << task << "level" << getLevelName(hgtSource) << (dryRun ? "(dry run)" : "");
+        if (dryRun) return true;
+
+        // one queued job, other workers wait until level is done
+        if ( ! queueDir.isEmpty()) {
+            indexes.append(0);
+            runQueue(hgtSource, indexes);
+            return true;
+        }
+        runWholeLevel(hgtSource);
+        return true;
+    }
+
+    indexes = getTileIndexes(hgtSource);
+    if (task==TASK_SIDECARS)
+        indexes = addNeighbors(indexes);
+    if ( ! queueDir.isEmpty() && ! dryRun) {
+        runQueue(hgtSource, indexes);
+        return true;
+    }
+    if (planner!=0) {
+        // seams between shards are stitched by merge when all shards are done
+        if (task==TASK_MERGE && ! dryRun && ! planner->waitForMarkers(getTaskName(TASK_CONNECT), hgtSource, waitTimeout))
+            return false;
+        planner->assign(indexes, hgtSource, task!=TASK_BUILD);
+        if (task==TASK_BUILD || task==TASK_SIDECARS) indexes = planner->getTiles(shard); else
+        if (task==TASK_CONNECT) indexes = planner->getInteriorTiles(shard); else
+                                indexes = planner->getSeamTiles();
+        if (task!=TASK_MERGE) {
+            LOG_INFO << "Shard" << shard << "of" << shards << ": load" << planner->getLoad(shard);
+        }
+    }
+    LOG_INFO << "Level" << getLevelName(hgtSource) << ":" << indexes.size() << "tiles" << (dryRun ? "(dry run)" : "");
+
+    // stitching changes neighbors, builds and sidecars are independent
+    parallel = memoryLimit>0 && (task==TASK_BUILD || task==TASK_SIDECARS);
+    jobMemory = (task==TASK_SIDECARS) ? MEMORY_JOB_SIDECARS : CMemoryBudget::getBuildJobMemory(hgtSource);
+    if (parallel) {
+        // tiles use all threads already, void filling of each one runs serially
+        pool.setMaxThreadCount(resizer->threadCount);
+        resizer->tileThreadCount = 1;
+        LOG_INFO << "Up to" << qMax((qint64)1, memoryLimit / jobMemory) << "tiles in parallel," << jobMemory / MEMORY_MB << "MB each";
+    }
+
+    for (i=0; i<indexes.size(); i++) {
+        if (dryRun) {
+            cacheManager->convertAvabilityIndex2TopLeft(indexes.at(i), cacheManager->getSourceDegreeSize(hgtSource), &tlLon, &tlLat);
+            cout << getLevelName(hgtSource).toAscii().data() << " " << indexes.at(i) << " "
+                 << QString::number(tlLon, 'f', 2).toAscii().data() << " "
+                 << QString::number(tlLat, 'f', 2).toAscii().data() << endl;
+            continue;
+        }
+
+        outputName = getOutputName(hgtSource, indexes.at(i));
+        if (resume && journal->isDone(getTaskName(task), hgtSource, indexes.at(i), outputName, task==TASK_BUILD || task==TASK_SIDECARS)) {
+            CRunReport::getInstance()->count("tilesResumed");
+            continue;
+        }
+
+        if (parallel) {
+            // waits here until tile fits into memory limit
+            CMemoryBudget::getInstance()->acquire(jobMemory);
+            pool.start(new CTaskJob(this, hgtSource, indexes.at(i), outputName, journal, jobMemory));
+            continue;
+        }
+        runJob(hgtSource, indexes.at(i), outputName, journal);
+    }
+    // next level and done marker need all tiles of this one
+    pool.waitForDone();
+    resizer->tileThreadCount = 0;
+
+    if (planner!=0 && task!=TASK_MERGE && ! dryRun)
+        planner->writeMarker(getTaskName(task), hgtSource, shard, indexes.size());
+
+    return true;
+}
+
+void CTaskRunner::runQueue(int hgtSource, const QList<int> &indexes)
+{
+    CShardPlanner planner(&resizer->cacheManager, 1, runId);
+    CWorkQueue queue(&resizer->cacheManager, queueDir, runId, getTaskName(task), hgtSource);
+    QList<int> jobs;
+    bool allDone;
+    bool ok;
+    int index;
+
+    // heaviest tiles first, light ones fill the end of level on all workers
+    if (isWholeLevelTask()) {
+        jobs = indexes;
+    } else {
+        planner.assign(indexes, hgtSource, task!=TASK_BUILD);
+        jobs = planner.getTilesByWeight();
+    }
+    LOG_INFO << "Level" << getLevelName(hgtSource) << ":" << jobs.size() << "jobs in queue" << queueDir;
+
+    while (true) {
+        index = queue.claim(jobs, task==TASK_CONNECT, &allDone);
+        if (index==-1) {
+            // next level reads tiles of this one, also those of other workers
+            if (allDone) break;
+            CWorkQueue::sleep(WORK_QUEUE_POLL);
+            continue;
+        }
+
+        CRunReport::getInstance()->count("jobsClaimed");
+        if (resume && ! isWholeLevelTask())
+            removeStaleTemp(hgtSource, index);
+        if (isWholeLevelTask()) ok = runWholeLevel(hgtSource); else
+                                ok = processTile(hgtSource, index);
+        if ( ! ok) {
+            LOG_ERROR << "Job" << index << "of level" << getLevelName(hgtSource) << "failed";
+            // whole level job counted levelsFailed already
+            if ( ! isWholeLevelTask())
+                CRunReport::getInstance()->count("tilesFailed");
+            queue.fail(index);
+            continue;
+        }
+        // tiles and sidecars are synced by CHgtFile::writeFileAtomic before job is done
+        queue.complete(index);
+    }
+}
+
+void CTaskRunner::runJob(int hgtSource, int index, const QString &outputName, CJournal *journal)
+{
+    if (resume)
+        removeStaleTemp(hgtSource, index);
+
+    // tile not written is built again by resumed run
+    if ( ! processTile(hgtSource, index)) {
+        LOG_ERROR << "Tile" << index << "of level" << getLevelName(hgtSource) << "failed";
+        CRunReport::getInstance()->count("tilesFailed");
+        return;
+    }
+
+    // tiles and sidecars are synced by CHgtFile::writeFileAtomic before they are journaled
+    journal->record(getTaskName(task), hgtSource, index, outputName);
+}
+
+bool CTaskRunner::isWholeLevelTask()
+{
+    return task==TASK_INDEX || task==TASK_EXPORT || task==TASK_RELIEF || task==TASK_PACK || task==TASK_UNPACK;
+}
+
+bool CTaskRunner::runWholeLevel(int hgtSource)
+{
+    if (task==TASK_INDEX) {
+        resizer->generateHtmlIndex(hgtSource, true, -1.0, -1.0, false);
+    } else if (task==TASK_EXPORT) {
+        CTileExporter exporter(resizer);
+        exporter.exportTiles(minZoom, maxZoom);
+    } else if (task==TASK_RELIEF) {
+        CReliefRenderer relief(resizer);
+        relief.render(hgtSource, -1.0, -1.0);
+    } else if (task==TASK_PACK) {
+        if ( ! CHgtArchive::pack(hgtSource)) {
+            LOG_ERROR << "Can't pack level" << getLevelName(hgtSource);
+            CRunReport::getInstance()->count("levelsFailed");
+            return false;
+        }
+    } else {
+        if ( ! CHgtArchive::unpack(hgtSource)) {
+            LOG_ERROR << "Can't unpack level" << getLevelName(hgtSource);
+            CRunReport::getInstance()->count("levelsFailed");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CTaskRunner::processTile(int hgtSource, int index)
+{
+    if (task==TASK_CONNECT || task==TASK_MERGE)
+        return resizer->connectL09_L13Terrain(index);
+    if (task==TASK_SIDECARS)
+        return resizer->rebuildL09_L13Sidecars(index);
+
+    switch (hgtSource) {
+        case HGT_SOURCE_L09_L13: return resizer->buildL09_L13TerrainFromSRTM(index);
+        case HGT_SOURCE_L04_L08: return resizer->buildL04_L08TerrainFromL09_L13(index);
+        case HGT_SOURCE_L00_L03: return resizer->buildL00_L03TerrainFromL04_L08(index);
+    }
+    return true;
+}
+
+void CTaskRunner::removeStaleTemp(int hgtSource, int index)
+{
+    QString name = getTileName(hgtSource, index) + ".tmp";
+
+    // left by interrupted CHgtFile::writeFileAtomic, tile itself is untouched
+    if (QFile::exists(name) && QFile::remove(name))
+        LOG_INFO << "Removed stale" << name;
+}
@@ -0,0 +1,127 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTASKRUNNER_H
+#define CTASKRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+class CResizer;
+class CShardPlanner;
+class CJournal;
+
+#define TASK_NONE                 0
+#define TASK_BUILD                1       // L09_L13 from SRTM, L04_L08 from L09_L13, L00_L03 from L04_L08
+#define TASK_CONNECT              2
+#define TASK_INDEX                3
+#define TASK_EXPORT               4
+#define TASK_RELIEF               5
+#define TASK_PACK                 6
+#define TASK_UNPACK               7
+#define TASK_MERGE                8       // stitch seams between shards of sharded connect
+#define TASK_SIDECARS             9       // statistics, min/max trees and LOD data of stitched L09_L13 tiles
+
+// Non-interactive batch run configured from command line, e.g.
+//   HgtResizer --task build --level L09_L13,L04_L08 --bbox -10,35,40,70
+// Entire earth on N machines sharing output root:
+//   HgtResizer --task build --level L09_L13,L04_L08,L00_L03 --shard k/N    on each
+//   HgtResizer --task connect --shard k/N                                  on each
+//   HgtResizer --task merge --shards N                                     on one
+//   HgtResizer --task sidecars --shard k/N                                 on each
+// or with jobs handed out dynamically from directory shared by all machines:
+//   HgtResizer --task build --level L09_L13,L04_L08,L00_L03 --queue <dir>  on each
+//   HgtResizer --task connect --queue <dir>                                on each
+//   HgtResizer --task sidecars --queue <dir>                               on each
+// Connect without shards and queue rebuilds sidecars itself.
+class CTaskRunner
+{
+public:
+    int task;
+    QList<int> hgtSources;           // processed in given order
+    bool hasBox;
+    double minLon, minLat, maxLon, maxLat;
+    int threads;                     // 0 = keep resizer default
+    QString inputRoot;
+    QString outputRoot;
+    int maxError;
+    int encoding;                    // HGT_ENCODING_* of written tiles, raw by default
+    int minZoom, maxZoom;            // export only
+    bool dryRun;
+    int shard;                       // this process of sharded run, -1 = not sharded
+    int shards;
+    QString runId;                   // names markers of this run, same in all its processes
+    int waitTimeout;                 // [s] for markers of other shards, 0 = no limit
+    bool resume;                     // skip tiles completed in journal of previous run
+    QString queueDir;                // claim tiles from work queue, empty = not used
+    qint64 memoryLimit;              // [B] builds tiles in parallel within it, 0 = one by one
+
+    CTaskRunner(CResizer *r);
+
+    bool parseArguments(const QStringList &args);
+    bool run();                      // false when tiles or levels failed or shards timed out
+    QList<int> getTileIndexes(int hgtSource);
+
+    static void printUsage();
+
+    // used by job threads only
+    void runJob(int hgtSource, int index, const QString &outputName, CJournal *journal);
+
+private:
+    CResizer *resizer;
+
+    bool parseTask(const QString &value);
+    bool parseLevels(const QString &value);
+    bool parseBox(const QString &value);
+    bool parseZoom(const QString &value);
+    bool parseShard(const QString &value);
+    bool parseEncoding(const QString &value);
+    bool runLevel(int hgtSource, CShardPlanner *planner, CJournal *journal);
+    void runQueue(int hgtSource, const QList<int> &indexes);
+    bool isWholeLevelTask();            // index, export, relief, pack, unpack
+    bool runWholeLevel(int hgtSource);
+    bool processTile(int hgtSource, int index);     // false when output could not be written
+    void removeStaleTemp(int hgtSource, int index);
+    QString getTileName(int hgtSource, int index);
+    QString getOutputName(int hgtSource, int index);
+    QList<int> addNeighbors(const QList<int> &indexes);
+    static QString getLevelName(int hgtSource);
+    static QString getTaskName(int t);
+};
+
+#endif // CTASKRUNNER_H
@@ -0,0 +1,560 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <fstream>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <QDebug>
+#include "CTerrainProfile.h"
+#include "CHgtFile.h"
+#include "CLog.h"
+
+using namespace std;
+
+#define PROFILE_PI                  3.14159265358979323846
+#define PROFILE_BATCH_SAMPLES       4000000
+
+CTerrainProfile::CTerrainProfile(CCacheManager *cm)
+{
+    cacheManager = cm;
+    earthRadius = 6371000.0;
+    refractionK = 4.0 / 3.0;
+    useMinMaxTree = true;
+}
+
+CTerrainProfile::~CTerrainProfile()
+{
+    clearMinMaxTrees();
+}
+
+CMinMaxTree *CTerrainProfile::getMinMaxTree(int L09_L13_index)
+{
+    CMinMaxTree *tree;
+
+    if (minMaxTrees.contains(L09_L13_index))
+        return minMaxTrees.value(L09_L13_index);
+    if (minMaxTrees.size()>=64)
+        clearMinMaxTrees();
+
+    // remember also missing trees (as 0) so they are not searched again
+    tree = new CMinMaxTree();
+    if ( ! tree->loadFile(cacheManager->pathL09_L13 + CMinMaxTree::getFileName(*cacheManager->avability_L09_L13[L09_L13_index].name))) {
+        delete tree;
+        tree = 0;
+    }
+    minMaxTrees.insert(L09_L13_index, tree);
+
+    return tree;
+}
+
+void CTerrainProfile::clearMinMaxTrees()
+{
+    QMap<int, CMinMaxTree *>::iterator it;
+
+    for (it=minMaxTrees.begin(); it!=minMaxTrees.end(); ++it)
+        if (it.value()!=0)
+            delete it.value();
+    minMaxTrees.clear();
+}
+
+bool CTerrainProfile::getHeightRangeInBox(const double &lonMin, const double &latMin, const double &lonMax, const double &latMax, int *min, int *max)
+{
+    int tilesX = (int)( (360.0 / HGT_SOURCE_DEGREE_SIZE_L09_L13) + 0.5 );
+    int tilesY = (int)( (180.0 / HGT_SOURCE_DEGREE_SIZE_L09_L13) + 0.5 );
+    double scale = (HGT_SOURCE_SIZE_L09_L13 - 1) / HGT_SOURCE_DEGREE_SIZE_L09_L13;
+    double tlLon, tlLat;
+    int tx0, tx1, ty0, ty1, tx, ty, index;
+    int tileMin, tileMax;
+    CMinMaxTree *tree;
+
+    // box in 0..360 longitude, not crossing 0 meridian
+    tx0 = (int)(lonMin / HGT_SOURCE_DEGREE_SIZE_L09_L13);
+    tx1 = (int)(lonMax / HGT_SOURCE_DEGREE_SIZE_L09_L13);
+    ty0 = (int)((90.0 - latMax) / HGT_SOURCE_DEGREE_SIZE_L09_L13);
+    ty1 = (int)((90.0 - latMin) / HGT_SOURCE_DEGREE_SIZE_L09_L13);
+    tx0 = qMax(tx0, 0); tx1 = qMin(tx1, tilesX-1);
+    ty0 = qMax(ty0, 0); ty1 = qMin(ty1, tilesY-1);
+
+    (*min) = 65535;
+    (*max) = 0;
+    for (ty=ty0; ty<=ty1; ty++)
+        for (tx=tx0; tx<=tx1; tx++) {
+            index = ty*tilesX + tx;
+
+            // sea level if no terrain
+            if ( ! cacheManager->avability_L09_L13[index].available) {
+                (*min) = 0;
+                continue;
+            }
+
+            tree = getMinMaxTree(index);
+            if (tree==0) return false;
+
+            cacheManager->convertAvabilityIndex2TopLeft(index, HGT_SOURCE_DEGREE_SIZE_L09_L13, &tlLon, &tlLat);
+            tree->getRange((int)floor((lonMin - tlLon) * scale), (int)floor((tlLat - latMax) * scale),
+                           (int)ceil((lonMax - tlLon) * scale),  (int)ceil((tlLat - latMin) * scale),
+                           &tileMin, &tileMax);
+            (*min) = qMin((*min), tileMin);
+            (*max) = qMax((*max), tileMax);
+        }
+
+    // voids only
+    if ((*min)>(*max)) {
+        (*min) = 0;
+        (*max) = 10;
+    }
+
+    return true;
+}
+
+double CTerrainProfile::getSpacingOfLOD(const int &lod)
+{
+    // each LOD chunk is a 8x8 grid of cells, so grid spacing is 1/8 of chunk degree size
+    return (cacheManager->LODdegreeSizeLookUp[lod] / 8.0) * (PROFILE_PI / 180.0) * earthRadius;
+}
+
+int CTerrainProfile::findLODForSpacing(const double &spacing)
+{
+    int lod;
+
+    // coarsest LOD that still has samples not further than requested spacing
+    for (lod=0; lod<=13; lod++)
+        if (getSpacingOfLOD(lod)<=spacing)
+            return lod;
+
+    return 13;
+}
+
+double CTerrainProfile::getGreatCircleDistance(const double &lon1, const double &lat1, const double &lon2, const double &lat2)
+{
+    double phi1, phi2, dPhi, dLambda, a;
+
+    phi1 = lat1 * (PROFILE_PI / 180.0);
+    phi2 = lat2 * (PROFILE_PI / 180.0);
+    dPhi = phi2 - phi1;
+    dLambda = (lon2 - lon1) * (PROFILE_PI / 180.0);
+
+    // haversine formula
+    a = sin(dPhi/2.0)*sin(dPhi/2.0) + cos(phi1)*cos(phi2)*sin(dLambda/2.0)*sin(dLambda/2.0);
+    if (a>1.0) a = 1.0;
+
+    return 2.0 * earthRadius * asin(sqrt(a));
+}
+
+bool CTerrainProfile::sampleGreatCircle(const double &lon1, const double &lat1, const double &lon2, const double &lat2, const double &spacing,
+                                        QVector<double> *lon, QVector<double> *lat)
+{
+    double x1, y1, z1, x2, y2, z2;
+    double angle, sinAngle, t, a, b;
+    double x, y, z, sampleLon;
+    int n, i, first;
+
+    // also NaN
+    if ( ! (spacing>0.0)) return false;
+
+    x1 = cos(lat1 * (PROFILE_PI / 180.0)) * cos(lon1 * (PROFILE_PI / 180.0));
+    y1 = cos(lat1 * (PROFILE_PI / 180.0)) * sin(lon1 * (PROFILE_PI / 180.0));
+    z1 = sin(lat1 * (PROFILE_PI / 180.0));
+    x2 = cos(lat2 * (PROFILE_PI / 180.0)) * cos(lon2 * (PROFILE_PI / 180.0));
+    y2 = cos(lat2 * (PROFILE_PI / 180.0)) * sin(lon2 * (PROFILE_PI / 180.0));
+    z2 = sin(lat2 * (PROFILE_PI / 180.0));
+
+    angle = getGreatCircleDistance(lon1, lat1, lon2, lat2) / earthRadius;
+    n = (int)ceil((angle * earthRadius) / spacing);
+    if (n<1) n = 1;
+    sinAngle = sin(angle);
+
+    first = lon->size();
+    lon->resize(first + n + 1);
+    lat->resize(first + n + 1);
+
+    // spherical linear interpolation between both end points
+    for (i=0; i<=n; i++) {
+        t = (double)i / (double)n;
+        if (sinAngle<1.0e-12) {
+            a = 1.0 - t;
+            b = t;
+        } else {
+            a = sin((1.0 - t) * angle) / sinAngle;
+            b = sin(t * angle) / sinAngle;
+        }
+        x = a*x1 + b*x2;
+        y = a*y1 + b*y2;
+        z = a*z1 + b*z2;
+
+        sampleLon = atan2(y, x) * (180.0 / PROFILE_PI);
+        if (sampleLon<0.0) sampleLon += 360.0;
+        (*lon)[first + i] = sampleLon;
+        (*lat)[first + i] = atan2(z, sqrt(x*x + y*y)) * (180.0 / PROFILE_PI);
+    }
+
+    return true;
+}
+
+bool CTerrainProfile::samplePolyline(const QVector<double> &lonIn, const QVector<double> &latIn, const double &spacing,
+                                     QVector<double> *lon, QVector<double> *lat)
+{
+    int i;
+
+    lon->clear();
+    lat->clear();
+    if ( ! (spacing>0.0)) return false;
+    for (i=0; i<lonIn.size()-1; i++) {
+        // skip first sample of next segment - it's the same as last one of previous
+        if (i>0) {
+            lon->resize(lon->size() - 1);
+            lat->resize(lat->size() - 1);
+        }
+        sampleGreatCircle(lonIn[i], latIn[i], lonIn[i+1], latIn[i+1], spacing, lon, lat);
+    }
+
+    return true;
+}
+
+void CTerrainProfile::getHeights(const QVector<double> &lon, const QVector<double> &lat, const int &lod, QVector<double> *height)
+{
+    int n = lon.size();
+    int hgtSource             = cacheManager->HGTsourceLookUp[lod];
+    double hgtSourceDegree    = cacheManager->HGTsourceDegreeSizeLookUp[lod];
+    int hgtSourceSize         = cacheManager->HGTsourceSizeLookUp[lod];
+    int skip                  = cacheManager->HGTsourceSkippingLookUp[lod];
+    int gridMax               = (hgtSourceSize - 1) / skip;
+    int tilesX                = (int)( (360.0 / hgtSourceDegree) + 0.5 );
+    int tilesY                = (int)( (180.0 / hgtSourceDegree) + 0.5 );
+    int *tileIndex            = new int[n];
+    int *tileFirst            = new int[tilesX*tilesY + 1];
+    int *order                = new int[n];
+    double *gridX             = new double[n];
+    double *gridY             = new double[n];
+    CAvability *avab = 0;
+    QString pathDir;
+    CHgtFile hgtFile;
+    double lonX, latY, fx, fy;
+    int tx, ty, ix, iy, i, j, k, tile;
+    int h00, h10, h01, h11;
+    double wx, wy;
+
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: avab = cacheManager->avability_L00_L03; pathDir = cacheManager->pathL00_L03; break;
+        case HGT_SOURCE_L04_L08: avab = cacheManager->avability_L04_L08; pathDir = cacheManager->pathL04_L08; break;
+        case HGT_SOURCE_L09_L13: avab = cacheManager->avability_L09_L13; pathDir = cacheManager->pathL09_L13; break;
+    }
+
+    height->resize(n);
+
+    // find tile and position on LOD grid for each sample
+    for (i=0; i<n; i++) {
+        lonX = lon[i];
+        if (lonX>=360.0) lonX -= 360.0;
+        if (lonX<0.0) lonX += 360.0;
+        latY = 90.0 - lat[i];
+
+        fx = lonX / hgtSourceDegree;
+        fy = latY / hgtSourceDegree;
+        tx = (int)fx;
+        ty = (int)fy;
+        if (tx>tilesX-1) tx = tilesX-1;
+        if (ty>tilesY-1) ty = tilesY-1;
+
+        tileIndex[i] = ty*tilesX + tx;
+        gridX[i] = (fx - tx) * gridMax;
+        gridY[i] = (fy - ty) * gridMax;
+    }
+
+    // counting sort of samples by tile - every tile is loaded only once
+    for (i=0; i<=tilesX*tilesY; i++)
+        tileFirst[i] = 0;
+    for (i=0; i<n; i++)
+        tileFirst[tileIndex[i] + 1]++;
+    for (i=0; i<tilesX*tilesY; i++)
+        tileFirst[i+1] += tileFirst[i];
+    for (i=0; i<n; i++)
+        order[tileFirst[tileIndex[i]]++] = i;
+
+    // walk tiles in order
+    i = 0;
+    while (i<n) {
+        tile = tileIndex[order[i]];
+        for (j=i; j<n && tileIndex[order[j]]==tile; j++) ;
+
+        if (avab[tile].available) {
+            hgtFile.loadTile(&avab[tile], pathDir, hgtSourceSize, hgtSourceSize);
+            for (k=i; k<j; k++) {
+                ix = (int)gridX[order[k]];
+                iy = (int)gridY[order[k]];
+                if (ix>gridMax-1) ix = gridMax-1;
+                if (iy>gridMax-1) iy = gridMax-1;
+                wx = gridX[order[k]] - ix;
+                wy = gridY[order[k]] - iy;
+
+                h00 = hgtFile.getHeight(ix*skip,     iy*skip);
+                h10 = hgtFile.getHeight(ix*skip+skip, iy*skip);
+                h01 = hgtFile.getHeight(ix*skip,     iy*skip+skip);
+                h11 = hgtFile.getHeight(ix*skip+skip, iy*skip+skip);
+                if (h00>9000) h00 = 10;
+                if (h10>9000) h10 = 10;
+                if (h01>9000) h01 = 10;
+                if (h11>9000) h11 = 10;
+
+                (*height)[order[k]] = (1.0-wy) * ((1.0-wx)*h00 + wx*h10) +
+                                      wy       * ((1.0-wx)*h01 + wx*h11);
+            }
+        } else {
+            // sea level if no terrain
+            for (k=i; k<j; k++)
+                (*height)[order[k]] = 0.0;
+        }
+
+        i = j;
+    }
+
+    delete []tileIndex;
+    delete []tileFirst;
+    delete []order;
+    delete []gridX;
+    delete []gridY;
+}
+
+bool CTerrainProfile::getProfile(const QVector<double> &lonIn, const QVector<double> &latIn, const double &spacing,
+                                 QVector<double> *lon, QVector<double> *lat, QVector<double> *height)
+{
+    if ( ! samplePolyline(lonIn, latIn, spacing, lon, lat)) return false;
+    getHeights(*lon, *lat, findLODForSpacing(spacing), height);
+
+    return true;
+}
+
+bool CTerrainProfile::lineOfSight(const QVector<CLineOfSightQuery> &queries, const double &spacing, QVector<CLineOfSightResult> *results)
+{
+    int n = queries.size();
+    int lod = findLODForSpacing(spacing);
+    double hgtSourceDegree = cacheManager->HGTsourceDegreeSizeLookUp[lod];
+    int tilesX = (int)( (360.0 / hgtSourceDegree) + 0.5 );
+    vector< pair<int, int> > keys(n);
+    int *order;
+    bool *resolved;
+    double midLon, midLat;
+    int i, first, samples, resolvedCount;
+
+    results->clear();
+    if ( ! (spacing>0.0)) return false;
+    results->resize(n);
+    order = new int[n];
+    resolved = new bool[n];
+
+    // sort queries by tile of middle point - neighbor queries share loaded tiles
+    for (i=0; i<n; i++) {
+        midLon = (queries[i].observerLon + queries[i].targetLon) / 2.0;
+        midLat = (queries[i].observerLat + queries[i].targetLat) / 2.0;
+        if (midLon>=360.0) midLon -= 360.0;
+        if (midLon<0.0) midLon += 360.0;
+        keys[i].first = ((int)((90.0 - midLat) / hgtSourceDegree)) * tilesX + (int)(midLon / hgtSourceDegree);
+        keys[i].second = i;
+    }
+    sort(keys.begin(), keys.end());
+
+    // links clearly above terrain don't need any terrain tile (only for LODs from L09-L13)
+    resolvedCount = 0;
+    for (i=0; i<n; i++) {
+        resolved[keys[i].second] = false;
+        if (useMinMaxTree && lod>=9)
+            resolved[keys[i].second] = lineOfSightByMinMaxTree(queries[keys[i].second], &(*results)[keys[i].second]);
+        if (resolved[keys[i].second])
+            resolvedCount++;
+    }
+    clearMinMaxTrees();
+    if (resolvedCount>0)
+        LOG_INFO << "Line of sight:" << resolvedCount << "/" << n << "resolved by min/max trees";
+
+    n = 0;
+    for (i=0; i<(int)keys.size(); i++)
+        if ( ! resolved[keys[i].second])
+            order[n++] = keys[i].second;
+
+    // process in batches that fits in memory
+    first = 0;
+    samples = 0;
+    for (i=0; i<n; i++) {
+        samples += (int)(getGreatCircleDistance(queries[order[i]].observerLon, queries[order[i]].observerLat,
+                                                queries[order[i]].targetLon, queries[order[i]].targetLat) / spacing) + 2;
+        if (samples>=PROFILE_BATCH_SAMPLES || i==n-1) {
+            LOG_INFO << "Line of sight:" << first << "-" << i << "/" << n;
+            lineOfSightBatch(queries, order, first, i-first+1, spacing, results);
+            first = i+1;
+            samples = 0;
+        }
+    }
+
+    delete []order;
+    delete []resolved;
+
+    return true;
+}
+
+bool CTerrainProfile::lineOfSightByMinMaxTree(const CLineOfSightQuery &query, CLineOfSightResult *result)
+{
+    QVector<double> lon, lat;
+    double distance, margin, maxBulge, lonMin, lonMax, latMin, latMax, hA, hB;
+    int minA, maxA, minB, maxB, minPath, maxPath;
+    int i;
+
+    distance = getGreatCircleDistance(query.observerLon, query.observerLat, query.targetLon, query.targetLat);
+    if (distance<=0.0) return false;
+
+    // bounding box of path from few great circle points, with margin of two samples
+    sampleGreatCircle(query.observerLon, query.observerLat, query.targetLon, query.targetLat, distance / 16.0, &lon, &lat);
+    lonMin = lonMax = lon[0];
+    latMin = latMax = lat[0];
+    for (i=1; i<lon.size(); i++) {
+        lonMin = qMin(lonMin, lon[i]); lonMax = qMax(lonMax, lon[i]);
+        latMin = qMin(latMin, lat[i]); latMax = qMax(latMax, lat[i]);
+    }
+    if (lonMax - lonMin > 180.0) return false;
+    margin = 2.0 * HGT_SOURCE_DEGREE_SIZE_L09_L13 / (HGT_SOURCE_SIZE_L09_L13 - 1);
+
+    // lower bound of both ends and upper bound of terrain between them
+    if ( ! getHeightRangeInBox(lon[0] - margin, lat[0] - margin, lon[0] + margin, lat[0] + margin, &minA, &maxA)) return false;
+    i = lon.size() - 1;
+    if ( ! getHeightRangeInBox(lon[i] - margin, lat[i] - margin, lon[i] + margin, lat[i] + margin, &minB, &maxB)) return false;
+    if ( ! getHeightRangeInBox(lonMin - margin, latMin - margin, lonMax + margin, latMax + margin, &minPath, &maxPath)) return false;
+
+    hA = minA + query.observerHeight;
+    hB = minB + query.targetHeight;
+    maxBulge = (distance * distance) / (8.0 * refractionK * earthRadius);
+    if ((double)maxPath + maxBulge >= qMin(hA, hB))
+        return false;
+
+    // clearly visible, clearance is only a lower bound here
+    result->visible = true;
+    result->clearance = qMin(hA, hB) - ((double)maxPath + maxBulge);
+    result->obstructionDistance = 0.0;
+    result->distance = distance;
+    result->exact = false;
+
+    return true;
+}
+
+void CTerrainProfile::lineOfSightBatch(const QVector<CLineOfSightQuery> &queries, const int *order, int first, int count,
+                                       const double &spacing, QVector<CLineOfSightResult> *results)
+{
+    QVector<double> lon, lat, height;
+    int *sampleFirst = new int[count + 1];
+    int lod = findLODForSpacing(spacing);
+    double distance, d, hA, hB, line, bulge, clearance;
+    int i, j, q, n;
+
+    // generate samples of all queries in batch and get heights in one tile walk
+    for (i=0; i<count; i++) {
+        q = order[first + i];
+        sampleFirst[i] = lon.size();
+        sampleGreatCircle(queries[q].observerLon, queries[q].observerLat,
+                          queries[q].targetLon, queries[q].targetLat, spacing, &lon, &lat);
+    }
+    sampleFirst[count] = lon.size();
+    getHeights(lon, lat, lod, &height);
+
+    for (i=0; i<count; i++) {
+        q = order[first + i];
+        n = sampleFirst[i+1] - sampleFirst[i] - 1;
+        distance = getGreatCircleDistance(queries[q].observerLon, queries[q].observerLat,
+                                          queries[q].targetLon, queries[q].targetLat);
+        hA = height[sampleFirst[i]]     + queries[q].observerHeight;
+        hB = height[sampleFirst[i] + n] + queries[q].targetHeight;
+
+        (*results)[q].distance = distance;
+        (*results)[q].exact = true;
+        // line starts and ends above terrain by antenna heights
+        (*results)[q].clearance = qMin(queries[q].observerHeight, queries[q].targetHeight);
+        (*results)[q].obstructionDistance = 0.0;
+
+        // compare line with terrain lifted by Earth curvature (bulge)
+        for (j=1; j<n; j++) {
+            d = distance * ((double)j / (double)n);
+            line = hA + (hB - hA) * ((double)j / (double)n);
+            bulge = (d * (distance - d)) / (2.0 * refractionK * earthRadius);
+            clearance = line - (height[sampleFirst[i] + j] + bulge);
+            if (clearance<(*results)[q].clearance) {
+                (*results)[q].clearance = clearance;
+                (*results)[q].obstructionDistance = d;
+            }
+        }
+        (*results)[q].visible = ((*results)[q].clearance >= 0.0);
+    }
+
+    delete []sampleFirst;
+}
+
+bool CTerrainProfile::lineOfSightBatchFile(const QString &queriesFilename, const QString &resultsFilename, const double &spacing)
+{
+    QVector<CLineOfSightQuery> queries;
+    QVector<CLineOfSightResult> results;
+    CLineOfSightQuery query;
+    fstream fileQueries, fileResults;
+    int i;
+
+    if ( ! (spacing>0.0)) {
+        LOG_ERROR << "Line of sight: spacing has to be positive, got" << spacing;
+        return false;
+    }
+
+    // each line: observerLon observerLat observerHeight targetLon targetLat targetHeight
+    LOG_INFO << "Line of sight: reading queries...";
+    fileQueries.open(queriesFilename.toAscii(), fstream::in);
+    while (fileQueries >> query.observerLon >> query.observerLat >> query.observerHeight
+                       >> query.targetLon >> query.targetLat >> query.targetHeight) {
+        queries.append(query);
+    }
+    fileQueries.close();
+    LOG_INFO << "Line of sight: reading queries... OK" << queries.size();
+
+    lineOfSight(queries, spacing, &results);
+
+    // each line: visible clearance obstructionDistance distance exact,
+    // exact=0 marks clearance as lower bound of link resolved by min/max trees
+    fileResults.open(resultsFilename.toAscii(), fstream::out);
+    fileResults.setf(ios::fixed);
+    fileResults.precision(2);
+    for (i=0; i<results.size(); i++) {
+        fileResults << (results[i].visible ? 1 : 0) << " " << results[i].clearance << " "
+                    << results[i].obstructionDistance << " " << results[i].distance << " "
+                    << (results[i].exact ? 1 : 0) << endl;
+    }
+    fileResults.close();
+
+    return true;
+}
@@ -0,0 +1,106 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTERRAINPROFILE_H
+#define CTERRAINPROFILE_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include "CCacheManager.h"
+#include "CMinMaxTree.h"
+
+class CLineOfSightQuery
+{
+public:
+    double observerLon;
+    double observerLat;
+    double observerHeight;       // meters above terrain
+    double targetLon;
+    double targetLat;
+    double targetHeight;         // meters above terrain
+};
+
+class CLineOfSightResult
+{
+public:
+    bool visible;
+    double clearance;            // min distance between line and terrain (negative when blocked)
+    double obstructionDistance;  // distance from observer to the worst sample, meters
+    double distance;             // great circle distance observer-target, meters
+    bool exact;                  // false for visible link resolved by min/max trees: clearance is
+                                 // only lower bound and obstructionDistance is 0
+};
+
+class CTerrainProfile
+{
+public:
+    double earthRadius;
+    double refractionK;          // effective Earth radius factor (4/3 for radio links)
+    bool useMinMaxTree;          // resolve clearly visible links with L09-L13 min/max trees,
+                                 // false gives exact clearance of every link
+
+    CTerrainProfile(CCacheManager *cm);
+    ~CTerrainProfile();
+
+    int findLODForSpacing(const double &spacing);
+    double getSpacingOfLOD(const int &lod);
+    double getGreatCircleDistance(const double &lon1, const double &lat1, const double &lon2, const double &lat2);
+    // sampling functions return false for spacing <= 0
+    bool sampleGreatCircle(const double &lon1, const double &lat1, const double &lon2, const double &lat2, const double &spacing,
+                           QVector<double> *lon, QVector<double> *lat);
+    bool samplePolyline(const QVector<double> &lonIn, const QVector<double> &latIn, const double &spacing,
+                        QVector<double> *lon, QVector<double> *lat);
+    void getHeights(const QVector<double> &lon, const QVector<double> &lat, const int &lod, QVector<double> *height);
+    bool getProfile(const QVector<double> &lonIn, const QVector<double> &latIn, const double &spacing,
+                    QVector<double> *lon, QVector<double> *lat, QVector<double> *height);
+    bool lineOfSight(const QVector<CLineOfSightQuery> &queries, const double &spacing, QVector<CLineOfSightResult> *results);
+    bool lineOfSightBatchFile(const QString &queriesFilename, const QString &resultsFilename, const double &spacing);
+    bool getHeightRangeInBox(const double &lonMin, const double &latMin, const double &lonMax, const double &latMax, int *min, int *max);
+
+private:
+    CCacheManager *cacheManager;
+    QMap<int, CMinMaxTree *> minMaxTrees;
+
+    CMinMaxTree *getMinMaxTree(int L09_L13_index);
+    void clearMinMaxTrees();
+    bool lineOfSightByMinMaxTree(const CLineOfSightQuery &query, CLineOfSightResult *result);
+    void lineOfSightBatch(const QVector<CLineOfSightQuery> &queries, const int *order, int first, int count,
+                          const double &spacing, QVector<CLineOfSightResult> *results);
+};
+
+#endif // CTERRAINPROFILE_H
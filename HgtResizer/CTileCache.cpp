@@ -0,0 +1,134 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include "CTileCache.h"
+#include "CCacheManager.h"
+
+CTileCache::CTileCache(int maxT)
+{
+    maxTiles = maxT;
+    useCounter = 0;
+}
+
+CTileCache::~CTileCache()
+{
+    QMap<int, CTileCacheEntry *>::iterator it;
+
+    for (it=entries.begin(); it!=entries.end(); ++it) {
+        delete it.value()->hgt;
+        delete it.value();
+    }
+}
+
+CHgtFile *CTileCache::acquire(int hgtSource, int index)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    CAvability *avab = cacheManager->getAvability(hgtSource);
+    int size = cacheManager->getSourceSize(hgtSource);
+    int key = hgtSource*1000000 + index;
+    CTileCacheEntry *entry;
+
+    if ( ! avab[index].available)
+        return 0;
+
+    QMutexLocker locker(&mutex);
+
+    if (entries.contains(key)) {
+        entry = entries.value(key);
+        // other thread is loading this tile right now
+        while (entry->loading)
+            loaded.wait(&mutex);
+        entry->references++;
+        entry->lastUse = useCounter++;
+        return entry->hgt;
+    }
+
+    evict();
+    entry = new CTileCacheEntry();
+    entry->hgt = new CHgtFile();
+    entry->references = 1;
+    entry->lastUse = useCounter++;
+    entry->loading = true;
+    entries.insert(key, entry);
+
+    // load without lock, other tiles can be used meanwhile
+    locker.unlock();
+    entry->hgt->loadTile(&avab[index], cacheManager->getPath(hgtSource), size, size);
+    locker.relock();
+
+    entry->loading = false;
+    loaded.wakeAll();
+
+    return entry->hgt;
+}
+
+void CTileCache::release(CHgtFile *hgt)
+{
+    QMap<int, CTileCacheEntry *>::iterator it;
+
+    if (hgt==0) return;
+
+    QMutexLocker locker(&mutex);
+    for (it=entries.begin(); it!=entries.end(); ++it)
+        if (it.value()->hgt==hgt) {
+            it.value()->references--;
+            break;
+        }
+}
+
+void CTileCache::evict()
+{
+    QMap<int, CTileCacheEntry *>::iterator it, oldest;
+    bool found;
+
+    // drop least recently used tiles nobody is using
+    while (entries.size()>=maxTiles) {
+        found = false;
+        for (it=entries.begin(); it!=entries.end(); ++it) {
+            if (it.value()->references>0 || it.value()->loading) continue;
+            if ( ! found || it.value()->lastUse < oldest.value()->lastUse) {
+                oldest = it;
+                found = true;
+            }
+        }
+        if ( ! found) return;
+
+        delete oldest.value()->hgt;
+        delete oldest.value();
+        entries.erase(oldest);
+    }
+}
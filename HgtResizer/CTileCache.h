@@ -0,0 +1,76 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTILECACHE_H
+#define CTILECACHE_H
+
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include "CHgtFile.h"
+
+class CTileCacheEntry
+{
+public:
+    CHgtFile *hgt;
+    int references;
+    int lastUse;
+    bool loading;
+};
+
+// Thread safe cache of loaded tiles shared by worker threads. Tiles are
+// read-only while acquired; unused tiles are dropped when cache is full.
+class CTileCache
+{
+public:
+    CTileCache(int maxT);
+    ~CTileCache();
+
+    CHgtFile *acquire(int hgtSource, int index);     // 0 if tile is not available
+    void release(CHgtFile *hgt);
+
+private:
+    QMap<int, CTileCacheEntry *> entries;
+    QMutex mutex;
+    QWaitCondition loaded;
+    int maxTiles;
+    int useCounter;
+
+    void evict();
+};
+
+#endif // CTILECACHE_H
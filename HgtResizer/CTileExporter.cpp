@@ -0,0 +1,320 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include "CTileExporter.h"
+#include "CResizer.h"
+#include "CHgtArchive.h"
+#include "CReliefRenderer.h"
+#include "CRunReport.h"
+#include "CScopedTimer.h"
+#include "CLog.h"
+
+using namespace std;
+
+#define EXPORTER_PI       3.14159265358979323846
+#define EXPORTER_MAX_LAT  85.0511287798
+
+CTileExporter::CTileExporter(CResizer *r)
+{
+    resizer = r;
+    hillshade = false;
+    threadCount = resizer->threadCount;
+    tileCache = new CTileCache(threadCount + 4);
+    // heights and image of one tile, source tiles are limited by cache
+    itemMemory = (TILE_EXPORTER_SIZE + 2)*(TILE_EXPORTER_SIZE + 2)*(sizeof(int) + sizeof(QRgb));
+    zoom = 0;
+    hgtSource = HGT_SOURCE_L00_L03;
+    skipped = 0;
+}
+
+CTileExporter::~CTileExporter()
+{
+    delete tileCache;
+}
+
+int CTileExporter::findSourceForZoom(int z)
+{
+    double pixelDegree = 360.0 / (TILE_EXPORTER_SIZE * (double)(1 << z));
+
+    // coarsest level with sample spacing not bigger than pixel
+    if (HGT_SOURCE_DEGREE_SIZE_L00_L03 / (HGT_SOURCE_SIZE_L00_L03 - 1) <= pixelDegree) return HGT_SOURCE_L00_L03;
+    if (HGT_SOURCE_DEGREE_SIZE_L04_L08 / (HGT_SOURCE_SIZE_L04_L08 - 1) <= pixelDegree) return HGT_SOURCE_L04_L08;
+    return HGT_SOURCE_L09_L13;
+}
+
+double CTileExporter::tileYToLat(double y)
+{
+    // y in tiles (fractional) on current zoom
+    double n = EXPORTER_PI * (1.0 - 2.0 * y / (double)(1 << zoom));
+    return atan(sinh(n)) * (180.0 / EXPORTER_PI);
+}
+
+int CTileExporter::latToTileY(double lat)
+{
+    double latRad;
+    int y;
+
+    if (lat>EXPORTER_MAX_LAT) lat = EXPORTER_MAX_LAT;
+    if (lat<-EXPORTER_MAX_LAT) lat = -EXPORTER_MAX_LAT;
+    latRad = lat * (EXPORTER_PI / 180.0);
+
+    y = (int)floor( (1.0 - log(tan(latRad) + 1.0/cos(latRad)) / EXPORTER_PI) / 2.0 * (1 << zoom) );
+    return qMax(0, qMin(y, (1 << zoom) - 1));
+}
+
+void CTileExporter::findSourceRange(int tx, int ty, int *sx0, int *sy0, int *sx1, int *sy1)
+{
+    double degree = resizer->cacheManager.getSourceDegreeSize(hgtSource);
+    int tilesX = (int)( (360.0 / degree) + 0.5 );
+    int tilesY = (int)( (180.0 / degree) + 0.5 );
+    double lonW, lonE;
+
+    // longitude of tile in 0..360, only tile of zoom 0 crosses 0 meridian
+    lonW = (tx / (double)(1 << zoom)) * 360.0 - 180.0;
+    lonE = ((tx+1) / (double)(1 << zoom)) * 360.0 - 180.0;
+    if (lonW<0.0) {
+        lonW += 360.0;
+        lonE += 360.0;
+    }
+
+    if (zoom==0) {
+        // whole earth, 180..540 would miss eastern hemisphere
+        (*sx0) = 0;
+        (*sx1) = tilesX-1;
+    } else {
+        (*sx0) = qMax(0, qMin((int)floor(lonW / degree), tilesX-1));
+        (*sx1) = qMax(0, qMin((int)floor(lonE / degree), tilesX-1));
+    }
+    (*sy0) = qMax(0, qMin((int)floor((90.0 - tileYToLat(ty)) / degree), tilesY-1));
+    (*sy1) = qMax(0, qMin((int)floor((90.0 - tileYToLat(ty+1)) / degree), tilesY-1));
+}
+
+void CTileExporter::exportTiles(int minZoom, int maxZoom)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    CAvability *avab;
+    QList<int> indexes;
+    vector< pair<int, int> > keys;
+    double degree, tlLon, tlLat, lonW, lonE;
+    int tilesX, tilesY, n, i, x, y, x0, x1, y0, y1, sx, sy;
+    QVector<bool> needed;
+
+    if (maxZoom>TILE_EXPORTER_MAX_ZOOM) maxZoom = TILE_EXPORTER_MAX_ZOOM;
+
+    for (zoom=minZoom; zoom<=maxZoom; zoom++) {
+        hgtSource = findSourceForZoom(zoom);
+        avab = cacheManager->getAvability(hgtSource);
+        degree = cacheManager->getSourceDegreeSize(hgtSource);
+        tilesX = (int)( (360.0 / degree) + 0.5 );
+        tilesY = (int)( (180.0 / degree) + 0.5 );
+        n = 1 << zoom;
+
+        // modification time of source tiles for incremental export, archived
+        // tiles have no loose file and are as new as their archive
+        sourceTime.fill(0, tilesX*tilesY);
+        for (i=0; i<tilesX*tilesY; i++) {
+            if ( ! avab[i].available) continue;
+            if (avab[i].archive!=0)
+                sourceTime[i] = QFileInfo(avab[i].archive->getName()).lastModified().toTime_t();
+            else
+                sourceTime[i] = QFileInfo(avab[i].getFilePath(cacheManager->getPath(hgtSource))).lastModified().toTime_t();
+        }
+
+        // only web tiles covering some source tile
+        needed.fill(false, n*n);
+        for (i=0; i<tilesX*tilesY; i++) {
+            if ( ! avab[i].available) continue;
+
+            cacheManager->convertAvabilityIndex2TopLeft(i, degree, &tlLon, &tlLat);
+            lonW = (tlLon>=180.0) ? tlLon - 360.0 : tlLon;
+            lonE = lonW + degree;
+            x0 = (int)floor((lonW + 180.0) / 360.0 * n);
+            x1 = (int)ceil((lonE + 180.0) / 360.0 * n) - 1;
+            y0 = latToTileY(tlLat);
+            y1 = latToTileY(tlLat - degree);
+            for (y=y0; y<=y1; y++)
+                for (x=qMax(x0, 0); x<=qMin(x1, n-1); x++)
+                    needed[y*n + x] = true;
+        }
+
+        // order by source tile of web tile center, so threads share loaded tiles
+        keys.clear();
+        for (i=0; i<n*n; i++) {
+            if ( ! needed[i]) continue;
+            findSourceRange(i % n, i / n, &x0, &y0, &x1, &y1);
+            sx = (x0 + x1) / 2;
+            sy = (y0 + y1) / 2;
+            keys.push_back(pair<int, int>(sy*tilesX + sx, i));
+        }
+        sort(keys.begin(), keys.end());
+        indexes.clear();
+        for (i=0; i<(int)keys.size(); i++)
+            indexes.append(keys[i].second);
+
+        skipped = 0;
+        run(indexes, "XYZ zoom " + QString::number(zoom));
+        LOG_INFO << "    up to date, skipped:" << skipped;
+    }
+}
+
+CTilePipelineItem *CTileExporter::produce(int index)
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    CTileExporterItem *item;
+    QMap<int, CHgtFile *> tiles;
+    QMap<int, CHgtFile *>::iterator it;
+    QFileInfo fileInfo;
+    int n = 1 << zoom;
+    int tx = index % n;
+    int ty = index / n;
+    double degree = cacheManager->getSourceDegreeSize(hgtSource);
+    int size = cacheManager->getSourceSize(hgtSource);
+    int tilesX = (int)( (360.0 / degree) + 0.5 );
+    int tilesY = (int)( (180.0 / degree) + 0.5 );
+    int grid = TILE_EXPORTER_SIZE + 2;          // one pixel border for hillshade
+    int *heights;
+    QRgb *line;
+    CHgtFile *hgt;
+    uint newestSource;
+    float rows[3*(TILE_EXPORTER_SIZE + 2)];
+    float p[TILE_EXPORTER_SIZE], q[TILE_EXPORTER_SIZE], shade[TILE_EXPORTER_SIZE];
+    float pixelMeters, factor;
+    double lat, lon, latY, fx, fy;
+    int sx0, sy0, sx1, sy1, sx, sy, r, c, i, h, src;
+    QRgb color;
+
+    item = new CTileExporterItem();
+    item->dir = cacheManager->pathXYZ + QString::number(zoom) + "/" + QString::number(tx);
+    item->filename = item->dir + "/" + QString::number(ty) + ".png";
+
+    // skip tile which is newer than all its sources
+    findSourceRange(tx, ty, &sx0, &sy0, &sx1, &sy1);
+    newestSource = 0;
+    for (sy=sy0; sy<=sy1; sy++)
+        for (sx=sx0; sx<=sx1; sx++)
+            newestSource = qMax(newestSource, sourceTime[sy*tilesX + sx]);
+    fileInfo.setFile(item->filename);
+    if (fileInfo.exists() && fileInfo.lastModified().toTime_t() > newestSource) {
+        skippedMutex.lock();
+        skipped++;
+        skippedMutex.unlock();
+        delete item;
+        return 0;
+    }
+
+    // heights of pixel centers, nearest sample
+    heights = new int[grid*grid];
+    for (r=0; r<grid; r++) {
+        lat = tileYToLat(ty + (r - 1 + 0.5) / TILE_EXPORTER_SIZE);
+        latY = 90.0 - lat;
+        sy = qMax(0, qMin((int)(latY / degree), tilesY-1));
+        fy = (latY - sy*degree) / degree * (size - 1);
+
+        for (c=0; c<grid; c++) {
+            lon = ((tx + (c - 1 + 0.5) / TILE_EXPORTER_SIZE) / (double)n) * 360.0 - 180.0;
+            if (lon<0.0) lon += 360.0;
+            if (lon>=360.0) lon -= 360.0;
+            sx = qMax(0, qMin((int)(lon / degree), tilesX-1));
+            fx = (lon - sx*degree) / degree * (size - 1);
+
+            src = sy*tilesX + sx;
+            if ( ! tiles.contains(src))
+                tiles.insert(src, tileCache->acquire(hgtSource, src));
+            hgt = tiles.value(src);
+
+            h = 0;
+            if (hgt!=0)
+                h = hgt->getHeight(qMin((int)(fx + 0.5), size-1), qMin((int)(fy + 0.5), size-1));
+            heights[r*grid + c] = h;
+        }
+    }
+    for (it=tiles.begin(); it!=tiles.end(); ++it)
+        tileCache->release(it.value());
+
+    item->image = QImage(TILE_EXPORTER_SIZE, TILE_EXPORTER_SIZE, QImage::Format_RGB32);
+    for (r=1; r<grid-1; r++) {
+        line = (QRgb *)item->image.scanLine(r-1);
+
+        if (hillshade) {
+            lat = tileYToLat(ty + (r - 1 + 0.5) / TILE_EXPORTER_SIZE);
+            // mercator pixel has the same ground size in both directions
+            pixelMeters = (float)( (360.0 / (TILE_EXPORTER_SIZE * (double)n)) * 111320.0 * cos(lat * (EXPORTER_PI / 180.0)) );
+            // voids are flat sea level, as in CReliefRenderer
+            for (c=0; c<grid; c++)
+                for (i=0; i<3; i++) {
+                    h = heights[(r-1+i)*grid + c];
+                    rows[i*grid + c] = (h>9000) ? 0.0f : (float)h;
+                }
+            CReliefRenderer::hornRow(&rows[0], &rows[grid], &rows[2*grid], TILE_EXPORTER_SIZE,
+                                     pixelMeters, pixelMeters, p, q);
+            CReliefRenderer::shadeRow(p, q, TILE_EXPORTER_SIZE, 315.0, 45.0, shade);
+        }
+
+        for (c=1; c<grid-1; c++) {
+            color = resizer->getLookUpColor(heights[r*grid + c]);
+
+            if (hillshade) {
+                // light from north-west, 45 deg above horizon
+                factor = 0.4f + 0.6f * qMin(shade[c-1] / 0.7071f, 1.0f);
+                color = qRgb((int)(qRed(color) * factor), (int)(qGreen(color) * factor), (int)(qBlue(color) * factor));
+            }
+
+            line[c-1] = color;
+        }
+    }
+
+    delete []heights;
+    return item;
+}
+
+void CTileExporter::consume(CTilePipelineItem *item)
+{
+    CTileExporterItem *exporterItem = (CTileExporterItem *)item;
+    QDir dir;
+    CScopedTimer timer("imageEncode");
+
+    dir.mkpath(exporterItem->dir);
+    exporterItem->image.save(exporterItem->filename, "PNG");
+    CRunReport::getInstance()->count("imagesWritten");
+}
@@ -0,0 +1,94 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTILEEXPORTER_H
+#define CTILEEXPORTER_H
+
+#include <QString>
+#include <QImage>
+#include <QVector>
+#include <QMutex>
+#include "CTilePipeline.h"
+#include "CTileCache.h"
+
+#define TILE_EXPORTER_SIZE          256
+#define TILE_EXPORTER_MAX_ZOOM       12
+
+class CResizer;
+
+class CTileExporterItem : public CTilePipelineItem
+{
+public:
+    QImage image;
+    QString dir;
+    QString filename;
+};
+
+// z/x/y web map (spherical mercator) PNG tiles rendered from L00-L03,
+// L04-L08 or L09-L13 - whichever is coarsest with enough detail for zoom.
+// Tiles without terrain are not written, tiles newer than all their
+// source files are skipped.
+class CTileExporter : public CTilePipeline
+{
+public:
+    bool hillshade;
+
+    CTileExporter(CResizer *r);
+    ~CTileExporter();
+
+    void exportTiles(int minZoom, int maxZoom);
+
+protected:
+    CTilePipelineItem *produce(int index);
+    void consume(CTilePipelineItem *item);
+
+private:
+    CResizer *resizer;
+    CTileCache *tileCache;
+    int zoom;
+    int hgtSource;
+    QVector<uint> sourceTime;       // last modification of source tiles, 0 = no tile
+    QMutex skippedMutex;
+    int skipped;
+
+    int findSourceForZoom(int z);
+    double tileYToLat(double y);
+    int latToTileY(double lat);
+    void findSourceRange(int tx, int ty, int *sx0, int *sy0, int *sx1, int *sy1);
+};
+
+#endif // CTILEEXPORTER_H
@@ -0,0 +1,201 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDebug>
+#include <QTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include "CTilePipeline.h"
+#include "CMemoryBudget.h"
+#include "CTrace.h"
+#include "CLog.h"
+
+class CTilePipelineWorker : public QRunnable
+{
+public:
+    CTilePipelineWorker(CTilePipeline *p, bool prod) { pipeline = p; producer = prod; }
+    void run() { if (producer) pipeline->runProducer(); else pipeline->runConsumer(); }
+
+private:
+    CTilePipeline *pipeline;
+    bool producer;
+};
+
+CTilePipelineItem::CTilePipelineItem()
+{
+    index = -1;
+    produceTime = 0;
+    consumeTime = 0;
+}
+
+CTilePipelineItem::~CTilePipelineItem()
+{
+}
+
+CTilePipeline::CTilePipeline()
+{
+    threadCount = QThread::idealThreadCount();
+    if (threadCount<1) threadCount = 1;
+    queueSize = 4;
+    itemMemory = 0;
+}
+
+CTilePipeline::~CTilePipeline()
+{
+}
+
+void CTilePipeline::run(const QList<int> &indexes, const QString &info)
+{
+    QThreadPool pool;
+    QTime timer;
+    int elapsed, i;
+
+    pending = indexes;
+    pendingNext = 0;
+    producersRunning = threadCount;
+    tilesDone = 0;
+    produceTimeTotal = 0;
+    consumeTimeTotal = 0;
+    produceTimeMax = 0;
+    consumeTimeMax = 0;
+
+    LOG_INFO << info << " pipeline:  " << pending.size() << " tiles, " << threadCount << " threads";
+    timer.start();
+
+    pool.setMaxThreadCount(2*threadCount);
+    for (i=0; i<threadCount; i++) {
+        pool.start(new CTilePipelineWorker(this, true));
+        pool.start(new CTilePipelineWorker(this, false));
+    }
+    pool.waitForDone();
+
+    elapsed = timer.elapsed();
+    LOG_INFO << info << " pipeline:  done " << tilesDone << " tiles in " << QString::number(elapsed / 1000.0, 'f', 1) << " s";
+    if (tilesDone>0) {
+        LOG_INFO << "    throughput:  " << QString::number(tilesDone / (qMax(elapsed, 1) / 1000.0), 'f', 2) << " tiles/s";
+        LOG_INFO << "    produce:     avg " << (int)(produceTimeTotal / tilesDone) << " ms, max " << produceTimeMax << " ms";
+        LOG_INFO << "    consume:     avg " << (int)(consumeTimeTotal / tilesDone) << " ms, max " << consumeTimeMax << " ms";
+    }
+}
+
+void CTilePipeline::runProducer()
+{
+    CTilePipelineItem *item;
+    QTime timer;
+    int index;
+
+    while (true) {
+        mutex.lock();
+        if (pendingNext>=pending.size()) {
+            // last producer wakes up consumers waiting for more tiles
+            producersRunning--;
+            queueNotEmpty.wakeAll();
+            mutex.unlock();
+            return;
+        }
+        index = pending.at(pendingNext++);
+        mutex.unlock();
+
+        CMemoryBudget::getInstance()->acquire(itemMemory);
+        timer.start();
+        CTrace::begin("produce", index);
+        item = produce(index);
+        CTrace::end("produce", index);
+        if (item==0) {
+            CMemoryBudget::getInstance()->release(itemMemory);
+            continue;
+        }
+        item->index = index;
+        item->produceTime = timer.elapsed();
+
+        mutex.lock();
+        if (queue.size()>=queueSize) {
+            // consumers are the bottleneck
+            CTrace::begin("waitQueueFull", index);
+            while (queue.size()>=queueSize)
+                queueNotFull.wait(&mutex);
+            CTrace::end("waitQueueFull", index);
+        }
+        queue.enqueue(item);
+        queueNotEmpty.wakeOne();
+        mutex.unlock();
+    }
+}
+
+void CTilePipeline::runConsumer()
+{
+    CTilePipelineItem *item;
+    QTime timer;
+
+    while (true) {
+        mutex.lock();
+        if (queue.isEmpty() && producersRunning>0) {
+            // producers are the bottleneck
+            CTrace::begin("waitQueueEmpty");
+            while (queue.isEmpty() && producersRunning>0)
+                queueNotEmpty.wait(&mutex);
+            CTrace::end("waitQueueEmpty");
+        }
+        if (queue.isEmpty()) {
+            mutex.unlock();
+            return;
+        }
+        item = queue.dequeue();
+        queueNotFull.wakeOne();
+        mutex.unlock();
+
+        timer.start();
+        CTrace::begin("consume", item->index);
+        consume(item);
+        CTrace::end("consume", item->index);
+        item->consumeTime = timer.elapsed();
+
+        LOG_INFO << "    tile " << item->index << ":  produce " << item->produceTime << " ms, consume " << item->consumeTime << " ms";
+
+        mutex.lock();
+        tilesDone++;
+        produceTimeTotal += item->produceTime;
+        consumeTimeTotal += item->consumeTime;
+        produceTimeMax = qMax(produceTimeMax, item->produceTime);
+        consumeTimeMax = qMax(consumeTimeMax, item->consumeTime);
+        mutex.unlock();
+
+        delete item;
+        CMemoryBudget::getInstance()->release(itemMemory);
+    }
+}
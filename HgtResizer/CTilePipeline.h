@@ -0,0 +1,99 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTILEPIPELINE_H
+#define CTILEPIPELINE_H
+
+#include <QString>
+#include <QList>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+
+class CTilePipelineItem
+{
+public:
+    int index;
+    int produceTime;       // ms
+    int consumeTime;       // ms
+
+    CTilePipelineItem();
+    virtual ~CTilePipelineItem();
+};
+
+// Two stage tile pipeline. Producer threads call produce() for each index
+// (load, color, render...) and put items to bounded queue, consumer threads
+// take them and call consume() (encode, write...). Bounded queue keeps
+// number of tiles in memory limited when encoding is slower than decoding.
+// Tile holds itemMemory of memory budget from produce() until consumed.
+class CTilePipeline
+{
+public:
+    int threadCount;
+    int queueSize;
+    qint64 itemMemory;      // estimate of one tile in flight, 0 = not budgeted
+
+    CTilePipeline();
+    virtual ~CTilePipeline();
+
+    void run(const QList<int> &indexes, const QString &info);
+
+    // used by worker threads only
+    void runProducer();
+    void runConsumer();
+
+protected:
+    virtual CTilePipelineItem *produce(int index) = 0;       // return 0 to skip tile
+    virtual void consume(CTilePipelineItem *item) = 0;       // item is deleted after
+
+private:
+    QList<int> pending;
+    int pendingNext;
+    QQueue<CTilePipelineItem *> queue;
+    int producersRunning;
+    QMutex mutex;
+    QWaitCondition queueNotEmpty;
+    QWaitCondition queueNotFull;
+
+    int tilesDone;
+    qint64 produceTimeTotal;
+    qint64 consumeTimeTotal;
+    int produceTimeMax;
+    int consumeTimeMax;
+};
+
+#endif // CTILEPIPELINE_H
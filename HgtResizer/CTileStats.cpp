@@ -0,0 +1,305 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include <QDataStream>
+#include "CTileStats.h"
+#include "CHgtFile.h"
+
+CTileStats::CTileStats()
+{
+    int i;
+
+    hgtSource = -1;
+    firstLOD = 0;
+    LODcount = 0;
+    for (i=0; i<14; i++) {
+        chunk[i] = 0;
+        chunkCount[i] = 0;
+    }
+}
+
+CTileStats::~CTileStats()
+{
+    clear();
+}
+
+void CTileStats::clear()
+{
+    int i;
+
+    for (i=0; i<14; i++) {
+        if (chunk[i]!=0)
+            delete []chunk[i];
+        chunk[i] = 0;
+        chunkCount[i] = 0;
+    }
+}
+
+void CTileStats::allocate(int hgtSrc)
+{
+    CCacheManager *cacheManager = CCacheManager::getInstance();
+    int lod, size;
+
+    clear();
+    hgtSource = hgtSrc;
+    switch (hgtSource) {
+        case HGT_SOURCE_L00_L03: firstLOD = 0; LODcount = 4; break;
+        case HGT_SOURCE_L04_L08: firstLOD = 4; LODcount = 5; break;
+        case HGT_SOURCE_L09_L13: firstLOD = 9; LODcount = 5; break;
+    }
+
+    // each LOD chunk is a 8x8 grid of cells
+    size = cacheManager->HGTsourceSizeLookUp[firstLOD];
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        chunkCount[lod] = (size - 1) / (8 * cacheManager->HGTsourceSkippingLookUp[lod]);
+        chunk[lod] = new CTileStatsRecord[chunkCount[lod] * chunkCount[lod]];
+    }
+}
+
+int CTileStats::getChunkCount(int lod)
+{
+    return chunkCount[lod];
+}
+
+CTileStatsRecord *CTileStats::getChunk(int lod, int cx, int cy)
+{
+    return &chunk[lod][cy*chunkCount[lod] + cx];
+}
+
+QString CTileStats::getFileName(const QString &hgtFilename)
+{
+    return hgtFilename.left(hgtFilename.length() - 4) + ".stats";
+}
+
+void CTileStats::compute(CHgtFile *hgt, int hgtSrc)
+{
+    int lastLOD, count, size, cx, cy, x, y, i, cyOwned;
+    int *rowMin, *rowMax, *rowVoids;
+    int *chunkMin, *chunkMax, *chunkVoids;
+    qint64 *rowSum, *chunkSum, *parentSum;
+    int *parentMin, *parentMax, *parentVoids;
+    qint64 tileSum;
+    quint16 *row;
+    int h, v, minH, maxH, sum, voids, lod, pc, px, py, c;
+
+    allocate(hgtSrc);
+    lastLOD = firstLOD + LODcount - 1;
+    count = chunkCount[lastLOD];
+    size = hgt->getSizeX();
+
+    rowMin   = new int[count];
+    rowMax   = new int[count];
+    rowVoids = new int[count];
+    rowSum   = new qint64[count];
+    chunkMin   = new int[count*count];
+    chunkMax   = new int[count*count];
+    chunkVoids = new int[count*count];
+    chunkSum   = new qint64[count*count];
+
+    for (i=0; i<count*count; i++) {
+        chunkMin[i] = 65535;
+        chunkMax[i] = 0;
+        chunkVoids[i] = 0;
+        chunkSum[i] = 0;
+    }
+
+    // finest LOD - one pass over tile, row by row. Min/max are over closed chunk
+    // (shared borders included), sum/voids over owned samples so merging is exact
+    for (y=0; y<size; y++) {
+        row = hgt->getHeightBuffer() + y*size;
+
+        for (cx=0; cx<count; cx++) {
+            minH = 65535; maxH = 0; sum = 0; voids = 0;
+            for (x=cx*8; x<cx*8+8; x++) {
+                h = row[x];
+                v = (h>9000);
+                minH = qMin(minH, v ? 65535 : h);
+                maxH = qMax(maxH, v ? 0 : h);
+                sum += v ? 0 : h;
+                voids += v;
+            }
+            rowSum[cx] = sum;
+            rowVoids[cx] = voids;
+
+            // shared right border sample
+            h = row[cx*8 + 8];
+            v = (h>9000);
+            rowMin[cx] = qMin(minH, v ? 65535 : h);
+            rowMax[cx] = qMax(maxH, v ? 0 : h);
+        }
+        // last column belongs to last chunk
+        rowSum[count-1] += (row[size-1]>9000) ? 0 : row[size-1];
+        rowVoids[count-1] += (row[size-1]>9000) ? 1 : 0;
+
+        cyOwned = qMin(y/8, count-1);
+        for (cx=0; cx<count; cx++) {
+            c = cyOwned*count + cx;
+            chunkMin[c] = qMin(chunkMin[c], rowMin[cx]);
+            chunkMax[c] = qMax(chunkMax[c], rowMax[cx]);
+            chunkSum[c] += rowSum[cx];
+            chunkVoids[c] += rowVoids[cx];
+        }
+        // shared bottom border row
+        if (y%8==0 && y>0 && y/8-1!=cyOwned) {
+            for (cx=0; cx<count; cx++) {
+                c = (y/8-1)*count + cx;
+                chunkMin[c] = qMin(chunkMin[c], rowMin[cx]);
+                chunkMax[c] = qMax(chunkMax[c], rowMax[cx]);
+            }
+        }
+    }
+
+    // build coarser LODs by merging 2x2 children
+    for (lod=lastLOD; lod>=firstLOD; lod--) {
+        pc = chunkCount[lod];
+
+        h = (size-1) / pc;
+        for (cy=0; cy<pc; cy++)
+            for (cx=0; cx<pc; cx++) {
+                i = cy*pc + cx;
+                // owned samples of chunk, last row/column belongs to last chunk
+                x = h + ((cx==pc-1) ? 1 : 0);
+                y = h + ((cy==pc-1) ? 1 : 0);
+                v = x*y - chunkVoids[i];
+
+                // chunk with voids only has zero min/max/mean
+                chunk[lod][i].min = (quint16)((chunkMin[i]<=chunkMax[i]) ? chunkMin[i] : 0);
+                chunk[lod][i].max = (quint16)((chunkMin[i]<=chunkMax[i]) ? chunkMax[i] : 0);
+                chunk[lod][i].mean = (quint16)((v>0) ? (chunkSum[i] + v/2) / v : 0);
+                chunk[lod][i].voids = (quint32)chunkVoids[i];
+            }
+
+        if (lod==firstLOD)
+            break;
+
+        parentMin   = new int[(pc/2)*(pc/2)];
+        parentMax   = new int[(pc/2)*(pc/2)];
+        parentVoids = new int[(pc/2)*(pc/2)];
+        parentSum   = new qint64[(pc/2)*(pc/2)];
+        for (py=0; py<pc/2; py++)
+            for (px=0; px<pc/2; px++) {
+                c = py*(pc/2) + px;
+                parentMin[c] = 65535; parentMax[c] = 0; parentVoids[c] = 0; parentSum[c] = 0;
+                for (i=0; i<4; i++) {
+                    cx = px*2 + (i%2);
+                    cy = py*2 + (i/2);
+                    parentMin[c] = qMin(parentMin[c], chunkMin[cy*pc + cx]);
+                    parentMax[c] = qMax(parentMax[c], chunkMax[cy*pc + cx]);
+                    parentVoids[c] += chunkVoids[cy*pc + cx];
+                    parentSum[c] += chunkSum[cy*pc + cx];
+                }
+            }
+        delete []chunkMin;   chunkMin = parentMin;
+        delete []chunkMax;   chunkMax = parentMax;
+        delete []chunkVoids; chunkVoids = parentVoids;
+        delete []chunkSum;   chunkSum = parentSum;
+    }
+
+    // whole tile
+    pc = chunkCount[firstLOD];
+    minH = 65535; maxH = 0; voids = 0; tileSum = 0;
+    for (i=0; i<pc*pc; i++) {
+        minH = qMin(minH, chunkMin[i]);
+        maxH = qMax(maxH, chunkMax[i]);
+        voids += chunkVoids[i];
+        tileSum += chunkSum[i];
+    }
+    v = size*size - voids;
+    tile.min = (quint16)((v>0) ? minH : 0);
+    tile.max = (quint16)((v>0) ? maxH : 0);
+    tile.mean = (quint16)((v>0) ? (tileSum + v/2) / v : 0);
+    tile.voids = (quint32)voids;
+
+    delete []rowMin;
+    delete []rowMax;
+    delete []rowVoids;
+    delete []rowSum;
+    delete []chunkMin;
+    delete []chunkMax;
+    delete []chunkVoids;
+    delete []chunkSum;
+}
+
+bool CTileStats::saveFile(QString name)
+{
+    QByteArray data;
+    int lod, i;
+
+    if (LODcount==0) return false;
+
+    // big endian, same as HGT files; torn file never replaces complete one
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << (quint32)TILE_STATS_MAGIC << (quint16)TILE_STATS_VERSION
+        << (quint16)hgtSource << (quint16)firstLOD << (quint16)LODcount;
+    out << tile.min << tile.max << tile.mean << tile.voids;
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        out << (quint16)chunkCount[lod];
+        for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+            out << chunk[lod][i].min << chunk[lod][i].max << chunk[lod][i].mean << chunk[lod][i].voids;
+    }
+
+    return CHgtFile::writeFileAtomic(name, data.constData(), data.size());
+}
+
+bool CTileStats::loadFile(QString name)
+{
+    QFile file(name);
+    quint32 magic;
+    quint16 version, src, first, count, chunks;
+    int lod, i;
+
+    if ( ! file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in >> magic >> version >> src >> first >> count;
+    if (magic!=TILE_STATS_MAGIC || version!=TILE_STATS_VERSION) {
+        file.close();
+        return false;
+    }
+
+    allocate(src);
+    in >> tile.min >> tile.max >> tile.mean >> tile.voids;
+    for (lod=firstLOD; lod<firstLOD+LODcount; lod++) {
+        in >> chunks;
+        for (i=0; i<chunkCount[lod]*chunkCount[lod]; i++)
+            in >> chunk[lod][i].min >> chunk[lod][i].max >> chunk[lod][i].mean >> chunk[lod][i].voids;
+    }
+    file.close();
+
+    return (in.status()==QDataStream::Ok);
+}
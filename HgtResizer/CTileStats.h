@@ -0,0 +1,83 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTILESTATS_H
+#define CTILESTATS_H
+
+#include <QString>
+#include "CCacheManager.h"
+#include "CHgtFile.h"
+
+#define TILE_STATS_MAGIC          0x48475453      // 'HGTS'
+#define TILE_STATS_VERSION        1
+
+class CTileStatsRecord
+{
+public:
+    quint16 min;           // min/max/mean of valid samples (height<=9000)
+    quint16 max;
+    quint16 mean;
+    quint32 voids;         // number of void samples (height>9000)
+};
+
+class CTileStats
+{
+public:
+    int hgtSource;
+    int firstLOD;
+    int LODcount;
+    CTileStatsRecord tile;
+
+    CTileStats();
+    ~CTileStats();
+
+    void compute(CHgtFile *hgt, int hgtSrc);
+    bool saveFile(QString name);
+    bool loadFile(QString name);
+    int getChunkCount(int lod);
+    CTileStatsRecord *getChunk(int lod, int cx, int cy);
+    static QString getFileName(const QString &hgtFilename);
+
+private:
+    CTileStatsRecord *chunk[14];       // chunk records of each LOD, row-major
+    int chunkCount[14];                // chunks per tile side in each LOD
+
+    void clear();
+    void allocate(int hgtSrc);
+};
+
+#endif // CTILESTATS_H
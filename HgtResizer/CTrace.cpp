@@ -0,0 +1,119 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include <QTextStream>
+#include "CTrace.h"
+
+bool CTrace::enabled = false;
+QElapsedTimer CTrace::clock;
+QThreadStorage<CTraceThread *> CTrace::threadBuffers;
+QList<CTraceBuffer *> CTrace::buffers;
+QMutex CTrace::buffersMutex;
+
+void CTrace::enable()
+{
+    clock.start();
+    enabled = true;
+}
+
+void CTrace::record(const char *name, char phase, int arg)
+{
+    CTraceThread *thread;
+    CTraceEvent *event;
+
+    // first event of thread registers its buffer
+    if ( ! threadBuffers.hasLocalData()) {
+        thread = new CTraceThread();
+        thread->buffer = new CTraceBuffer();
+        thread->buffer->written = 0;
+        buffersMutex.lock();
+        thread->buffer->threadId = buffers.size() + 1;
+        buffers.append(thread->buffer);
+        buffersMutex.unlock();
+        threadBuffers.setLocalData(thread);
+    }
+    thread = threadBuffers.localData();
+
+    event = &thread->buffer->events[thread->buffer->written % TRACE_BUFFER_EVENTS];
+    event->name = name;
+    event->time = clock.nsecsElapsed() / 1000;
+    event->arg = arg;
+    event->phase = phase;
+    thread->buffer->written++;
+}
+
+bool CTrace::saveFile(const QString &name)
+{
+    QMutexLocker locker(&buffersMutex);
+    QFile file(name);
+    CTraceBuffer *buffer;
+    CTraceEvent *event;
+    qint64 i, first;
+    bool firstEvent;
+    int b;
+
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+
+    out << "{\"traceEvents\":[";
+    firstEvent = true;
+    for (b=0; b<buffers.size(); b++) {
+        buffer = buffers.at(b);
+        first = qMax((qint64)0, buffer->written - TRACE_BUFFER_EVENTS);
+
+        out << (firstEvent ? "\n" : ",\n");
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+        firstEvent = false;
+
+        for (i=first; i<buffer->written; i++) {
+            event = &buffer->events[i % TRACE_BUFFER_EVENTS];
+            out << ",\n{\"name\":\"" << event->name << "\",\"ph\":\"" << event->phase
+                << "\",\"ts\":" << event->time << ",\"pid\":1,\"tid\":" << buffer->threadId;
+            if (event->arg>=0)
+                out << ",\"args\":{\"tile\":" << event->arg << "}";
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    file.close();
+
+    return true;
+}
@@ -0,0 +1,109 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CTRACE_H
+#define CTRACE_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QThreadStorage>
+
+#define TRACE_FILENAME            "trace.json"
+#define TRACE_BUFFER_EVENTS       65536       // per thread, oldest events are overwritten
+
+class CTraceEvent
+{
+public:
+    const char *name;      // string literal, only pointer is stored
+    qint64 time;           // [us] since CTrace::enable
+    int arg;               // tile index or -1
+    char phase;            // 'B' begin, 'E' end
+};
+
+class CTraceBuffer
+{
+public:
+    CTraceEvent events[TRACE_BUFFER_EVENTS];
+    qint64 written;
+    int threadId;
+};
+
+// QThreadStorage deletes its data when thread exits, buffer must survive
+class CTraceThread
+{
+public:
+    CTraceBuffer *buffer;
+};
+
+// Opt-in timeline of stages and tiles for each thread, saved as Chrome trace
+// JSON (chrome://tracing, ui.perfetto.dev). Every thread writes only to its
+// own ring buffer, so recording takes no lock. Disabled tracing costs one
+// test of static flag per event.
+class CTrace
+{
+public:
+    static bool enabled;
+
+    static void enable();
+    static void begin(const char *name, int arg = -1) { if (enabled) record(name, 'B', arg); }
+    static void end(const char *name, int arg = -1) { if (enabled) record(name, 'E', arg); }
+    static bool saveFile(const QString &name);      // call when worker threads are finished
+
+private:
+    static QElapsedTimer clock;
+    static QThreadStorage<CTraceThread *> threadBuffers;
+    static QList<CTraceBuffer *> buffers;
+    static QMutex buffersMutex;                     // guards only registration of new thread
+
+    static void record(const char *name, char phase, int arg);
+};
+
+// Begin event in constructor, end event at end of scope
+class CTraceScope
+{
+public:
+    CTraceScope(const char *n, int a = -1) { name = n; arg = a; CTrace::begin(name, arg); }
+    ~CTraceScope() { CTrace::end(name, arg); }
+
+private:
+    const char *name;
+    int arg;
+};
+
+#endif // CTRACE_H
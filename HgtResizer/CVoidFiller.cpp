@@ -0,0 +1,378 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <QDebug>
+#include <QTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include "CVoidFiller.h"
+#include "alglib/interpolation.h"
+#include "CLog.h"
+
+#define VOID_FILLER_PI          3.14159265358979323846
+#define VOID_FILLER_COARSEST    1024        // samples of level solved directly
+#define VOID_FILLER_SMOOTHING   50          // SOR sweeps on finer levels at most
+
+class CVoidFillerWorker : public QRunnable
+{
+public:
+    CVoidFillerWorker(CVoidFiller *f) { filler = f; }
+    void run() { filler->runWorker(); }
+
+private:
+    CVoidFiller *filler;
+};
+
+static bool biggerRegion(const CVoidRegion &a, const CVoidRegion &b)
+{
+    return a.count > b.count;
+}
+
+CVoidFiller::CVoidFiller()
+{
+    threadCount = QThread::idealThreadCount();
+    if (threadCount<1) threadCount = 1;
+    smallRegionSize = 16;
+    maxIterations = 1000;
+    tolerance = 0.01f;
+    noDataHeight = 10;
+
+    hgt = 0;
+    height = 0;
+    sizeX = 0;
+    sizeY = 0;
+    label = 0;
+    nextRegion = 0;
+}
+
+CVoidFiller::~CVoidFiller()
+{
+}
+
+int CVoidFiller::fill(CHgtFile *h)
+{
+    QThreadPool pool;
+    QTime timer;
+    int filled, i;
+
+    hgt = h;
+    height = hgt->getHeightBuffer();
+    sizeX = hgt->getSizeX();
+    sizeY = hgt->getSizeY();
+
+    timer.start();
+    label = new int[sizeX*sizeY];
+    labelRegions();
+
+    filled = 0;
+    for (i=0; i<regions.size(); i++)
+        filled += regions.at(i).count;
+
+    // biggest regions first, small ones balance threads at the end
+    std::sort(regions.begin(), regions.end(), biggerRegion);
+    nextRegion = 0;
+    if ( ! regions.isEmpty()) {
+        pool.setMaxThreadCount(threadCount);
+        for (i=0; i<qMin(threadCount, regions.size()); i++)
+            pool.start(new CVoidFillerWorker(this));
+        pool.waitForDone();
+    }
+
+    LOG_INFO << "    void regions:" << regions.size() << " samples:" << filled
+             << " time:" << timer.elapsed() << "ms";
+
+    delete []label;
+    label = 0;
+    regions.clear();
+
+    return filled;
+}
+
+void CVoidFiller::runWorker()
+{
+    CVoidRegion region;
+
+    while (true) {
+        mutex.lock();
+        if (nextRegion>=regions.size()) {
+            mutex.unlock();
+            return;
+        }
+        region = regions.at(nextRegion++);
+        mutex.unlock();
+
+        if (region.count<=smallRegionSize)
+            fillSmall(region); else
+            fillLaplace(region);
+    }
+}
+
+void CVoidFiller::labelRegions()
+{
+    CVoidRegion region;
+    QList<int> stack;
+    int i, p, x, y, count;
+
+    // 0 - valid sample, -1 - void not labelled yet, >0 - region label
+    count = sizeX*sizeY;
+    for (i=0; i<count; i++)
+        label[i] = (height[i]>9000) ? -1 : 0;
+
+    regions.clear();
+    for (i=0; i<count; i++) {
+        if (label[i]!=-1) continue;
+
+        region.label = regions.size() + 1;
+        region.count = 0;
+        region.x0 = region.x1 = i % sizeX;
+        region.y0 = region.y1 = i / sizeX;
+
+        // flood fill with explicit stack
+        label[i] = region.label;
+        stack.append(i);
+        while ( ! stack.isEmpty()) {
+            p = stack.takeLast();
+            x = p % sizeX;
+            y = p / sizeX;
+            region.count++;
+            region.x0 = qMin(region.x0, x); region.x1 = qMax(region.x1, x);
+            region.y0 = qMin(region.y0, y); region.y1 = qMax(region.y1, y);
+
+            if (x>0       && label[p-1]==-1)     { label[p-1] = region.label;     stack.append(p-1); }
+            if (x<sizeX-1 && label[p+1]==-1)     { label[p+1] = region.label;     stack.append(p+1); }
+            if (y>0       && label[p-sizeX]==-1) { label[p-sizeX] = region.label; stack.append(p-sizeX); }
+            if (y<sizeY-1 && label[p+sizeX]==-1) { label[p+sizeX] = region.label; stack.append(p+sizeX); }
+        }
+
+        regions.append(region);
+    }
+}
+
+void CVoidFiller::fillSmall(const CVoidRegion &region)
+{
+    int x0 = qMax(region.x0 - 1, 0);
+    int y0 = qMax(region.y0 - 1, 0);
+    int x1 = qMin(region.x1 + 1, sizeX - 1);
+    int y1 = qMin(region.y1 + 1, sizeY - 1);
+    alglib::real_2d_array xy;
+    alglib::real_1d_array point;
+    alglib::idwinterpolant z;
+    int x, y, n, dx, dy, p;
+    bool border;
+    double h;
+
+    // valid samples touching region (8-neighbourhood) are interpolation nodes
+    xy.setlength((x1-x0+1)*(y1-y0+1), 3);
+    n = 0;
+    for (y=y0; y<=y1; y++)
+        for (x=x0; x<=x1; x++) {
+            if (label[y*sizeX + x]!=0) continue;
+            border = false;
+            for (dy=-1; dy<=1; dy++)
+                for (dx=-1; dx<=1; dx++)
+                    if (x+dx>=0 && x+dx<sizeX && y+dy>=0 && y+dy<sizeY && label[(y+dy)*sizeX + x+dx]==region.label)
+                        border = true;
+            if ( ! border) continue;
+
+            xy[n][0] = x;
+            xy[n][1] = y;
+            xy[n][2] = height[y*sizeX + x];
+            n++;
+        }
+
+    if (n==0) {
+        for (y=region.y0; y<=region.y1; y++)
+            for (x=region.x0; x<=region.x1; x++)
+                if (label[y*sizeX + x]==region.label)
+                    height[y*sizeX + x] = (quint16)noDataHeight;
+        return;
+    }
+
+    // linear nodal functions need some nodes, constant ones are fine for tiny holes
+    alglib::idwbuildmodifiedshepard(xy, n, 2, (n>=8) ? 1 : 0, 15, 25, z);
+    point.setlength(2);
+    for (y=region.y0; y<=region.y1; y++)
+        for (x=region.x0; x<=region.x1; x++) {
+            p = y*sizeX + x;
+            if (label[p]!=region.label) continue;
+            point[0] = x;
+            point[1] = y;
+            h = alglib::idwcalc(z, point);
+            height[p] = (quint16)qMax(0, qMin((int)(h + 0.5), 9000));
+        }
+}
+
+void CVoidFiller::relax(float *value, const uchar *state, int w, int h, int iterations)
+{
+    int x, y, i, iteration, color, count;
+    float sum, delta, maxDelta, omega;
+
+    // red-black SOR of free samples (state 1), state 2 samples are not neighbours
+    omega = (float)( 2.0 / (1.0 + sin(VOID_FILLER_PI / qMax(qMax(w, h), 2))) );
+    for (iteration=0; iteration<iterations; iteration++) {
+        maxDelta = 0.0f;
+        for (color=0; color<2; color++)
+            for (y=0; y<h; y++)
+                for (x=(y+color)%2; x<w; x+=2) {
+                    i = y*w + x;
+                    if (state[i]!=1) continue;
+
+                    sum = 0.0f; count = 0;
+                    if (x>0   && state[i-1]!=2) { sum += value[i-1]; count++; }
+                    if (x<w-1 && state[i+1]!=2) { sum += value[i+1]; count++; }
+                    if (y>0   && state[i-w]!=2) { sum += value[i-w]; count++; }
+                    if (y<h-1 && state[i+w]!=2) { sum += value[i+w]; count++; }
+                    if (count==0) continue;
+
+                    delta = omega * (sum / count - value[i]);
+                    value[i] += delta;
+                    maxDelta = qMax(maxDelta, fabsf(delta));
+                }
+        if (maxDelta<tolerance)
+            break;
+    }
+}
+
+void CVoidFiller::solve(float *value, float *weight, const uchar *state, int w, int h)
+{
+    float *coarseValue, *coarseWeight;
+    uchar *coarseState;
+    int cw = (w + 1) / 2;
+    int ch = (h + 1) / 2;
+    int x, y, cx, cy, c, i;
+    float sw, sv;
+
+    // cascadic multigrid: coarse level solved first (recursively) is pushed
+    // down as start value, then SOR removes what is left on this level
+    if (w*h > VOID_FILLER_COARSEST) {
+        coarseValue = new float[cw*ch];
+        coarseWeight = new float[cw*ch];
+        coarseState = new uchar[cw*ch];
+
+        // pull - weighted 2x2 average of known samples, weight saturates at 1
+        for (cy=0; cy<ch; cy++)
+            for (cx=0; cx<cw; cx++) {
+                sw = 0.0f; sv = 0.0f;
+                for (i=0; i<4; i++) {
+                    x = cx*2 + (i%2);
+                    y = cy*2 + (i/2);
+                    if (x>=w || y>=h) continue;
+                    sw += weight[y*w + x];
+                    sv += weight[y*w + x] * value[y*w + x];
+                }
+                c = cy*cw + cx;
+                coarseValue[c] = (sw>0.0f) ? sv / sw : 0.0f;
+                coarseWeight[c] = qMin(sw, 1.0f);
+                coarseState[c] = (sw>=1.0f) ? 0 : 1;
+            }
+
+        solve(coarseValue, coarseWeight, coarseState, cw, ch);
+
+        // push - missing part of weight comes from coarser level
+        for (y=0; y<h; y++)
+            for (x=0; x<w; x++) {
+                i = y*w + x;
+                c = (y/2)*cw + (x/2);
+                value[i] = weight[i]*value[i] + (1.0f - weight[i])*coarseValue[c];
+            }
+
+        delete []coarseValue;
+        delete []coarseWeight;
+        delete []coarseState;
+
+        relax(value, state, w, h, VOID_FILLER_SMOOTHING);
+    } else {
+        // start from mean of known samples
+        sw = 0.0f; sv = 0.0f;
+        for (i=0; i<w*h; i++) {
+            sw += weight[i];
+            sv += weight[i] * value[i];
+        }
+        for (i=0; i<w*h; i++)
+            if (state[i]==1)
+                value[i] = (sw>0.0f) ? sv / sw : 0.0f;
+
+        relax(value, state, w, h, maxIterations);
+    }
+}
+
+void CVoidFiller::fillLaplace(const CVoidRegion &region)
+{
+    int x0 = qMax(region.x0 - 1, 0);
+    int y0 = qMax(region.y0 - 1, 0);
+    int x1 = qMin(region.x1 + 1, sizeX - 1);
+    int y1 = qMin(region.y1 + 1, sizeY - 1);
+    int w = x1 - x0 + 1;
+    int h = y1 - y0 + 1;
+    float *value, *weight;
+    uchar *state;
+    int x, y, i, l, known;
+
+    // compact copy of bounding box: 0 - valid, 1 - unknown, 2 - other void
+    value = new float[w*h];
+    weight = new float[w*h];
+    state = new uchar[w*h];
+    known = 0;
+    for (y=0; y<h; y++)
+        for (x=0; x<w; x++) {
+            i = y*w + x;
+            l = label[(y0+y)*sizeX + x0+x];
+            state[i] = (l==0) ? 0 : ((l==region.label) ? 1 : 2);
+            value[i] = (l==0) ? (float)height[(y0+y)*sizeX + x0+x] : 0.0f;
+            weight[i] = (l==0) ? 1.0f : 0.0f;
+            known += (l==0);
+        }
+
+    if (known==0) {
+        for (i=0; i<w*h; i++)
+            value[i] = (float)noDataHeight;
+    } else {
+        solve(value, weight, state, w, h);
+    }
+
+    for (y=0; y<h; y++)
+        for (x=0; x<w; x++)
+            if (state[y*w + x]==1)
+                height[(y0+y)*sizeX + x0+x] = (quint16)qMax(0, qMin((int)(value[y*w + x] + 0.5f), 9000));
+
+    delete []value;
+    delete []weight;
+    delete []state;
+}
@@ -0,0 +1,93 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CVOIDFILLER_H
+#define CVOIDFILLER_H
+
+#include <QList>
+#include <QMutex>
+#include "CHgtFile.h"
+
+class CVoidRegion
+{
+public:
+    int label;
+    int count;             // number of void samples
+    int x0, y0, x1, y1;    // bounding box, inclusive
+};
+
+// Fills voids (height>9000) of terrain. Void samples are labelled to 4-connected
+// regions, small regions are interpolated by ALGLIB modified Shepard IDW from
+// valid samples around, bigger ones get Laplace (membrane) inpainting - smooth
+// surface with valid samples around as boundary. Laplace equation is solved
+// coarse to fine (pull-push pyramid, red-black SOR on each level) on compact
+// copy of the region bounding box. Regions are solved in parallel.
+class CVoidFiller
+{
+public:
+    int threadCount;
+    int smallRegionSize;       // regions up to this size use IDW
+    int maxIterations;
+    float tolerance;           // [m] max change of SOR sweep to stop
+    int noDataHeight;          // height of region without any valid sample around
+
+    CVoidFiller();
+    ~CVoidFiller();
+
+    int fill(CHgtFile *hgt);   // returns number of filled samples
+
+    // used by worker threads only
+    void runWorker();
+
+private:
+    CHgtFile *hgt;
+    quint16 *height;
+    int sizeX;
+    int sizeY;
+    int *label;
+    QList<CVoidRegion> regions;
+    int nextRegion;
+    QMutex mutex;
+
+    void labelRegions();
+    void fillSmall(const CVoidRegion &region);
+    void fillLaplace(const CVoidRegion &region);
+    void solve(float *value, float *weight, const uchar *state, int w, int h);
+    void relax(float *value, const uchar *state, int w, int h, int iterations);
+};
+
+#endif // CVOIDFILLER_H
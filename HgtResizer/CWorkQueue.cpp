@@ -0,0 +1,322 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTextStream>
+#include <QCoreApplication>
+#include "CWorkQueue.h"
+#include "CLog.h"
+#include "CRunReport.h"
+
+CWorkQueueHeartbeat::CWorkQueueHeartbeat(CWorkQueue *q)
+{
+    queue = q;
+    running = true;
+}
+
+void CWorkQueueHeartbeat::run()
+{
+    mutex.lock();
+    while (running) {
+        stopped.wait(&mutex, WORK_QUEUE_HEARTBEAT*1000);
+        if (running)
+            queue->touchAll();
+    }
+    mutex.unlock();
+}
+
+void CWorkQueueHeartbeat::stop()
+{
+    mutex.lock();
+    running = false;
+    stopped.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+int CWorkQueue::instances = 0;
+
+CWorkQueue::CWorkQueue(CCacheManager *cm, const QString &d, const QString &runId, const QString &task, int hgtSource)
+{
+    QString host = QString::fromLocal8Bit(qgetenv("HOSTNAME"));
+
+    if (host.isEmpty()) host = QString::fromLocal8Bit(qgetenv("COMPUTERNAME"));
+    workerId = host + "_" + QString::number(QCoreApplication::applicationPid());
+    // pid alone is reused by restarted worker, its old locks are not its own
+    token = workerId + "_" + QDateTime::currentDateTime().toString("yyyyMMddhhmmsszzz") + "_" +
+            QString::number(instances++);
+    beats = 0;
+    lease = WORK_QUEUE_LEASE;
+
+    cacheManager = cm;
+    dir = d;
+    if ( ! dir.endsWith("/") && ! dir.endsWith("\\")) dir += "/";
+    QDir().mkpath(dir);
+    prefix = runId + "_" + task + "_" + QString::number(hgtSource) + "_";
+    cursor = 0;
+
+    heartbeat = new CWorkQueueHeartbeat(this);
+    heartbeat->start();
+}
+
+CWorkQueue::~CWorkQueue()
+{
+    heartbeat->stop();
+    delete heartbeat;
+    release();
+}
+
+void CWorkQueue::sleep(int ms)
+{
+    QMutex mutex;
+    QWaitCondition never;
+
+    mutex.lock();
+    never.wait(&mutex, ms);
+    mutex.unlock();
+}
+
+bool CWorkQueue::isDone(int index)
+{
+    if (knownDone.contains(index)) return true;
+    if ( ! QFile::exists(getDoneName(index))) return false;
+
+    knownDone.insert(index);
+    return true;
+}
+
+QString CWorkQueue::readHeartbeat(const QString &lock)
+{
+    QFile file(lock + "/heartbeat");
+    QString content;
+
+    if ( ! file.open(QIODevice::ReadOnly | QIODevice::Text)) return "";
+    content = QString::fromAscii(file.readAll().constData());
+    file.close();
+
+    return content.trimmed();
+}
+
+bool CWorkQueue::isOwned(const QString &lock)
+{
+    return readHeartbeat(lock).section(' ', 0, 0)==token;
+}
+
+bool CWorkQueue::touch(const QString &lock, bool create)
+{
+    QFile file(lock + "/heartbeat");
+
+    // lock taken over by other worker keeps its heartbeat
+    if ( ! create && ! isOwned(lock)) return false;
+
+    // changing content is seen by other workers whatever their clocks are
+    beats++;
+    if ( ! file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return true;
+    QTextStream out(&file);
+    out << token << " " << beats << "\n";
+    out.flush();
+    file.close();
+
+    return true;
+}
+
+void CWorkQueue::touchAll()
+{
+    QMutexLocker locker(&heldMutex);
+    int i;
+
+    for (i=held.size()-1; i>=0; i--)
+        if ( ! touch(held.at(i), false)) {
+            LOG_WARNING << "Lease of" << held.at(i) << "was taken over by other worker";
+            held.removeAt(i);
+        }
+}
+
+bool CWorkQueue::isExpired(const QString &lock, QString *heartbeat)
+{
+    QDateTime now = QDateTime::currentDateTime();
+    CWorkQueueObservation observation;
+
+    if ( ! QFileInfo(lock).exists()) return false;
+
+    // empty heartbeat of worker that died between mkdir and first write
+    // expires the same way
+    (*heartbeat) = readHeartbeat(lock);
+    if ( ! observed.contains(lock) || observed.value(lock).heartbeat!=(*heartbeat)) {
+        observation.heartbeat = (*heartbeat);
+        observation.since = now;
+        observed.insert(lock, observation);
+        return false;
+    }
+
+    return observed.value(lock).since.secsTo(now) > lease;
+}
+
+void CWorkQueue::removeLock(const QString &lock)
+{
+    QFile::remove(lock + "/heartbeat");
+    QDir().rmdir(lock);
+}
+
+bool CWorkQueue::tryLock(int index)
+{
+    QString lock = getLockName(index);
+    QString stale = lock + ".stale_" + token;
+    QString heartbeat;
+
+    if ( ! QDir().mkdir(lock)) {
+        if ( ! isExpired(lock, &heartbeat)) return false;
+
+        // steal from dead worker, only one rename of lock can succeed
+        if ( ! QDir().rename(lock, stale)) return false;
+        observed.remove(lock);
+        // holder could beat between check and rename, it is alive then
+        if (readHeartbeat(stale)!=heartbeat) {
+            if ( ! QDir().rename(stale, lock))
+                LOG_WARNING << "Can't give" << lock << "back to its holder";
+            return false;
+        }
+        LOG_WARNING << "Lease of" << lock << "expired, taking job over";
+        removeLock(stale);
+        CRunReport::getInstance()->count("jobsStolen");
+        if ( ! QDir().mkdir(lock)) return false;
+    }
+
+    QMutexLocker locker(&heldMutex);
+    touch(lock, true);
+    held.append(lock);
+
+    return true;
+}
+
+bool CWorkQueue::tryClaim(int index, bool stitching)
+{
+    int i, neighbor;
+
+    if ( ! tryLock(index)) return false;
+    // other worker could finish it between check and lock
+    if (QFile::exists(getDoneName(index))) {
+        knownDone.insert(index);
+        release();
+        return false;
+    }
+    if ( ! stitching) return true;
+
+    // stitching changes borders of all neighbors, nobody else may stitch them now
+    for (i=0; i<9; i++) {
+        if (i==4) continue;
+        neighbor = cacheManager->getNeighborAvabilityIndex(index, HGT_SOURCE_DEGREE_SIZE_L09_L13, i%3 - 1, i/3 - 1);
+        if (neighbor!=-1 && ! tryLock(neighbor)) {
+            release();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int CWorkQueue::claim(const QList<int> &indexes, bool stitching, bool *allDone)
+{
+    int i, index;
+
+    (*allDone) = false;
+    if (indexes.isEmpty()) {
+        (*allDone) = true;
+        return -1;
+    }
+
+    // one pass from last claimed job, jobs locked by others are checked
+    // again on next call (done by now or lease expired)
+    for (i=0; i<indexes.size(); i++) {
+        index = indexes.at((cursor + i) % indexes.size());
+        if (isDone(index)) continue;
+        if (tryClaim(index, stitching)) {
+            cursor = (cursor + i + 1) % indexes.size();
+            return index;
+        }
+    }
+
+    (*allDone) = true;
+    for (i=0; i<indexes.size(); i++)
+        if ( ! isDone(indexes.at(i))) (*allDone) = false;
+
+    return -1;
+}
+
+void CWorkQueue::complete(int index)
+{
+    QFile file(getDoneName(index));
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << workerId << " " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+        file.close();
+    }
+    QFile::remove(getFailedName(index));
+    knownDone.insert(index);
+    release();
+}
+
+void CWorkQueue::fail(int index)
+{
+    QFile file(getFailedName(index));
+
+    // failed job is not claimed again by this worker, so level still
+    // finishes; file only reports it, other and restarted workers retry it
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << workerId << " " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+        file.close();
+    }
+    knownDone.insert(index);
+    release();
+}
+
+void CWorkQueue::release()
+{
+    QMutexLocker locker(&heldMutex);
+    int i;
+
+    // lock taken over after our lease expired belongs to other worker now
+    for (i=0; i<held.size(); i++)
+        if (isOwned(held.at(i)))
+            removeLock(held.at(i));
+    held.clear();
+}
@@ -0,0 +1,141 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CWORKQUEUE_H
+#define CWORKQUEUE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QMap>
+#include <QDateTime>
+#include "CCacheManager.h"
+
+#define WORK_QUEUE_HEARTBEAT      30        // [s] held locks are touched this often
+#define WORK_QUEUE_LEASE         300        // [s] lock with unchanged heartbeat is stolen after
+#define WORK_QUEUE_POLL         5000        // [ms] wait when all remaining tiles are locked
+
+class CWorkQueue;
+
+class CWorkQueueObservation
+{
+public:
+    QString heartbeat;                  // content of heartbeat file
+    QDateTime since;                    // local time it was first seen
+};
+
+class CWorkQueueHeartbeat : public QThread
+{
+public:
+    CWorkQueueHeartbeat(CWorkQueue *q);
+    void stop();
+
+protected:
+    void run();
+
+private:
+    CWorkQueue *queue;
+    QMutex mutex;
+    QWaitCondition stopped;
+    bool running;
+};
+
+// Tile jobs shared by worker processes through directory, local or NFS.
+// Job is claimed by creating lock directory <run>_<task>_<level>_<index>.lock
+// (mkdir is atomic even on NFS). Its heartbeat file holds owner token and
+// counter rewritten by background thread. Clocks of hosts and NFS times are
+// not compared: lock whose heartbeat did not change during lease, measured by
+// observing worker, belongs to dead worker. It is renamed away (only one
+// worker succeeds), checked again and job is claimed again. Workers remove
+// only locks with their own token.
+// Finished job gets .done file, worker started again with the same run id
+// skips these jobs, new run id processes everything. Job whose output could
+// not be written is given up only by worker that failed it, its .failed file
+// is a report; other and restarted workers retry it. Stitching locks
+// neighbors too, their borders change.
+class CWorkQueue
+{
+public:
+    CWorkQueue(CCacheManager *cm, const QString &d, const QString &runId, const QString &task, int hgtSource);
+    ~CWorkQueue();
+
+    // next job not done and not locked, -1 if there is none right now,
+    // allDone is set when every job is finished
+    int claim(const QList<int> &indexes, bool stitching, bool *allDone);
+    void complete(int index);
+    void fail(int index);
+    void release();
+    void touchAll();
+    void setLease(int seconds) { lease = seconds; }
+
+    static void sleep(int ms);
+
+private:
+    CCacheManager *cacheManager;
+    QString dir;
+    QString prefix;
+    QString workerId;
+    QString token;                      // owner of locks, unique per queue instance
+    qint64 beats;
+    int lease;                          // [s] WORK_QUEUE_LEASE
+    QStringList held;                   // lock directories of current job
+    QMutex heldMutex;
+    QSet<int> knownDone;
+    QMap<QString, CWorkQueueObservation> observed;  // heartbeats of locks of other workers
+    int cursor;
+    CWorkQueueHeartbeat *heartbeat;
+
+    static int instances;
+
+    QString getLockName(int index) { return dir + prefix + QString::number(index) + ".lock"; }
+    QString getDoneName(int index) { return dir + prefix + QString::number(index) + ".done"; }
+    QString getFailedName(int index) { return dir + prefix + QString::number(index) + ".failed"; }
+    bool isDone(int index);
+    bool tryLock(int index);
+    bool tryClaim(int index, bool stitching);
+    bool isExpired(const QString &lock, QString *heartbeat);
+    bool isOwned(const QString &lock);
+    void removeLock(const QString &lock);
+    bool touch(const QString &lock, bool create);
+    static QString readHeartbeat(const QString &lock);
+};
+
+#endif // CWORKQUEUE_H
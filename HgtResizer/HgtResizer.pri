@@ -0,0 +1,97 @@
+# Sources shared by HgtResizer and benchmark targets, everything except main.cpp
+
+INCLUDEPATH += $$PWD
+
+# let compiler vectorize per-tile reductions and copy loops
+*-g++* {
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -O3 -fno-math-errno
+}
+
+# process memory counters of run report
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    $$PWD/CHgtFile.cpp \
+    $$PWD/CCacheManager.cpp \
+    $$PWD/CAvability.cpp \
+    $$PWD/alglib/statistics.cpp \
+    $$PWD/alglib/specialfunctions.cpp \
+    $$PWD/alglib/solvers.cpp \
+    $$PWD/alglib/optimization.cpp \
+    $$PWD/alglib/linalg.cpp \
+    $$PWD/alglib/interpolation.cpp \
+    $$PWD/alglib/integration.cpp \
+    $$PWD/alglib/fasttransforms.cpp \
+    $$PWD/alglib/diffequations.cpp \
+    $$PWD/alglib/dataanalysis.cpp \
+    $$PWD/alglib/ap.cpp \
+    $$PWD/alglib/alglibmisc.cpp \
+    $$PWD/alglib/alglibinternal.cpp \
+    $$PWD/CResizer.cpp \
+    $$PWD/CTerrainProfile.cpp \
+    $$PWD/CTileStats.cpp \
+    $$PWD/CMinMaxTree.cpp \
+    $$PWD/CTilePipeline.cpp \
+    $$PWD/CIndexImagePipeline.cpp \
+    $$PWD/CTileCache.cpp \
+    $$PWD/CTileExporter.cpp \
+    $$PWD/CReliefRenderer.cpp \
+    $$PWD/CLodData.cpp \
+    $$PWD/CVoidFiller.cpp \
+    $$PWD/CResampler.cpp \
+    $$PWD/CHgtCodec.cpp \
+    $$PWD/CHgtArchive.cpp \
+    $$PWD/CRunReport.cpp \
+    $$PWD/CScopedTimer.cpp \
+    $$PWD/CTrace.cpp \
+    $$PWD/CLog.cpp \
+    $$PWD/CStitchStats.cpp \
+    $$PWD/CTaskRunner.cpp \
+    $$PWD/CShardPlanner.cpp \
+    $$PWD/CJournal.cpp \
+    $$PWD/CWorkQueue.cpp \
+    $$PWD/CMemoryBudget.cpp
+
+HEADERS += \
+    $$PWD/CHgtFile.h \
+    $$PWD/CCacheManager.h \
+    $$PWD/CAvability.h \
+    $$PWD/alglib/stdafx.h \
+    $$PWD/alglib/statistics.h \
+    $$PWD/alglib/specialfunctions.h \
+    $$PWD/alglib/solvers.h \
+    $$PWD/alglib/optimization.h \
+    $$PWD/alglib/linalg.h \
+    $$PWD/alglib/interpolation.h \
+    $$PWD/alglib/integration.h \
+    $$PWD/alglib/fasttransforms.h \
+    $$PWD/alglib/diffequations.h \
+    $$PWD/alglib/dataanalysis.h \
+    $$PWD/alglib/ap.h \
+    $$PWD/alglib/alglibmisc.h \
+    $$PWD/alglib/alglibinternal.h \
+    $$PWD/CResizer.h \
+    $$PWD/CTerrainProfile.h \
+    $$PWD/CTileStats.h \
+    $$PWD/CMinMaxTree.h \
+    $$PWD/CTilePipeline.h \
+    $$PWD/CIndexImagePipeline.h \
+    $$PWD/CTileCache.h \
+    $$PWD/CTileExporter.h \
+    $$PWD/CReliefRenderer.h \
+    $$PWD/CLodData.h \
+    $$PWD/CVoidFiller.h \
+    $$PWD/CResampler.h \
+    $$PWD/CHgtCodec.h \
+    $$PWD/CHgtArchive.h \
+    $$PWD/CRunReport.h \
+    $$PWD/CScopedTimer.h \
+    $$PWD/CTrace.h \
+    $$PWD/CLog.h \
+    $$PWD/CStitchStats.h \
+    $$PWD/CTaskRunner.h \
+    $$PWD/CShardPlanner.h \
+    $$PWD/CJournal.h \
+    $$PWD/CWorkQueue.h \
+    $$PWD/CMemoryBudget.h
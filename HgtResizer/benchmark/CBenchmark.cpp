@@ -0,0 +1,275 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTime>
+#include "CBenchmark.h"
+#include "CSyntheticTerrain.h"
+#include "CResizer.h"
+#include "CResampler.h"
+#include "CHgtCodec.h"
+#include "alglib/interpolation.h"
+
+CBenchmark::CBenchmark(CResizer *r)
+{
+    resizer = r;
+    block = new quint16[301*301];
+    rawFilename = "benchmark_raw.hgt";
+    encodedFilename = "benchmark_encoded.hgt";
+    colorSum = 0;
+}
+
+CBenchmark::~CBenchmark()
+{
+    delete []block;
+}
+
+void CBenchmark::setup()
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    CSyntheticTerrain terrain;
+    QString root;
+    QDir dir;
+    int x, y;
+
+    // all files of benchmark go to temp directory, level directories of
+    // working directory are never overwritten
+    root = QDir::toNativeSeparators(QDir::tempPath() + "/HgtResizer_benchmark");
+    cacheManager->setupPaths(root, root);
+    rawFilename = cacheManager->pathBase + "benchmark_raw.hgt";
+    encodedFilename = cacheManager->pathBase + "benchmark_encoded.hgt";
+    qDebug() << "Benchmark directory: " << root;
+
+    dir.mkpath(cacheManager->pathSRTM);
+    dir.mkpath(cacheManager->pathL09_L13);
+    dir.mkpath(cacheManager->pathL04_L08);
+    dir.mkpath(cacheManager->pathL00_L03);
+
+    // 5x5 SRTM tiles under benchmarked L09-L13 tile and its E neighbour
+    qDebug() << "Benchmark setup - synthetic SRTM tiles...";
+    terrain.writeSRTMTiles(cacheManager, BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT + 0.5, 8, 5);
+    cacheManager->setupAvabilityTables();
+    qDebug() << "Benchmark setup - synthetic SRTM tiles... OK";
+
+    splineSource.init(BENCHMARK_SPLINE_OLD_SIZE, BENCHMARK_SPLINE_OLD_SIZE);
+    splineResult.init(BENCHMARK_SPLINE_NEW_SIZE, BENCHMARK_SPLINE_NEW_SIZE);
+    for (y=0; y<BENCHMARK_SPLINE_OLD_SIZE; y++)
+        for (x=0; x<BENCHMARK_SPLINE_OLD_SIZE; x++)
+            splineSource.setHeight(x, y, terrain.getHeight(BENCHMARK_TILE_LON*1200 + x, (90.0 - BENCHMARK_TILE_LAT)*1200 + y));
+}
+
+void CBenchmark::runAll()
+{
+    CCacheManager *cacheManager = &resizer->cacheManager;
+    qint64 tileSamples = (qint64)HGT_SOURCE_SIZE_L09_L13*HGT_SOURCE_SIZE_L09_L13;
+    qint64 tileBytes = tileSamples*2;
+    qint64 splineSamples = (qint64)BENCHMARK_SPLINE_NEW_SIZE*BENCHMARK_SPLINE_NEW_SIZE;
+    QString filename;
+    int saveEncoding = CHgtFile::saveEncoding;
+
+    // pipeline stages once - they produce tiles for the other cases
+    measure(CASE_BUILD_L09_L13, "buildL09_L13TerrainFromSRTM", tileSamples, tileBytes, 0);
+    resizer->buildL09_L13TerrainFromSRTM(BENCHMARK_TILE_LON + HGT_SOURCE_DEGREE_SIZE_L09_L13, BENCHMARK_TILE_LAT);
+    cacheManager->setupAvabilityTables();
+    measure(CASE_CONNECT_L09_L13, "connectL09_L13Terrain", 4*HGT_SOURCE_SIZE_L09_L13, 4*2*HGT_SOURCE_SIZE_L09_L13, 0);
+    measure(CASE_BUILD_L04_L08, "buildL04_L08TerrainFromL09_L13",
+            (qint64)HGT_SOURCE_SIZE_L04_L08*HGT_SOURCE_SIZE_L04_L08, (qint64)HGT_SOURCE_SIZE_L04_L08*HGT_SOURCE_SIZE_L04_L08*2, 0);
+    cacheManager->setupAvabilityTables();
+    measure(CASE_BUILD_L00_L03, "buildL00_L03TerrainFromL04_L08",
+            (qint64)HGT_SOURCE_SIZE_L00_L03*HGT_SOURCE_SIZE_L00_L03, (qint64)HGT_SOURCE_SIZE_L00_L03*HGT_SOURCE_SIZE_L00_L03*2, 0);
+
+    // built tile is the input of all file and memory cases
+    cacheManager->convertLonLatToFileName(BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT, &filename);
+    tile.loadFile(cacheManager->pathL09_L13 + filename, HGT_SOURCE_SIZE_L09_L13, HGT_SOURCE_SIZE_L09_L13);
+    scratch.loadFile(cacheManager->pathL09_L13 + filename, HGT_SOURCE_SIZE_L09_L13, HGT_SOURCE_SIZE_L09_L13);
+    CHgtFile::saveEncoding = HGT_ENCODING_RAW;
+    scratch.saveFile(rawFilename);
+    CHgtFile::saveEncoding = HGT_ENCODING_AUTO;
+    tile.saveFile(encodedFilename);
+    qDebug() << "Encoded tile: " << QFileInfo(encodedFilename).size() << " bytes";
+
+    measure(CASE_LOAD_RAW, "loadFile raw", tileSamples, tileBytes, BENCHMARK_MIN_TIME);
+    CHgtFile::saveEncoding = HGT_ENCODING_RAW;
+    measure(CASE_SAVE_RAW, "saveFile raw", tileSamples, tileBytes, BENCHMARK_MIN_TIME);
+    CHgtFile::saveEncoding = HGT_ENCODING_AUTO;
+    measure(CASE_SAVE_ENCODED, "saveFile encoded", tileSamples, tileBytes, BENCHMARK_MIN_TIME);
+    measure(CASE_LOAD_ENCODED, "loadFile encoded", tileSamples, tileBytes, BENCHMARK_MIN_TIME);
+    measure(CASE_LOAD_ENCODED_SKIP, "loadFile encoded rowSkip 16", tileSamples/16, tileBytes/16, BENCHMARK_MIN_TIME);
+    CHgtFile::saveEncoding = saveEncoding;
+
+    measure(CASE_EXCHANGE_ENDIAN, "exchangeEndian", tileSamples, tileBytes, BENCHMARK_MIN_TIME);
+    measure(CASE_GET_BLOCK, "getHeightBlock 301x301", 13*13*301*301, 13*13*301*301*2, BENCHMARK_MIN_TIME);
+    measure(CASE_SET_BLOCK, "setHeightBlock 301x301", 13*13*301*301, 13*13*301*301*2, BENCHMARK_MIN_TIME);
+    measure(CASE_GET_BLOCK_SKIP, "getHeightBlock 129x129 skip 32", 129*129, 129*129*2, BENCHMARK_MIN_TIME);
+
+    measure(CASE_SPLINE_ALGLIB, "spline2dresamplebicubic", splineSamples, splineSamples*2, 0);
+    measure(CASE_SPLINE_RESAMPLER, "CResampler::resample", splineSamples, splineSamples*2, BENCHMARK_MIN_TIME);
+
+    measure(CASE_GET_COLOR, "getColor", 65536, 65536*4, BENCHMARK_MIN_TIME);
+    measure(CASE_COLORIZE, "colorizeImage", tileSamples, tileSamples*4, BENCHMARK_MIN_TIME);
+
+    QFile::remove(rawFilename);
+    QFile::remove(encodedFilename);
+}
+
+void CBenchmark::measure(int testCase, const QString &name, qint64 samples, qint64 bytes, int minTime)
+{
+    CBenchmarkRecord record;
+    QTime timer;
+
+    record.name = name;
+    record.repeats = 0;
+    timer.start();
+    do {
+        runCase(testCase);
+        record.repeats++;
+    } while (timer.elapsed()<minTime);
+
+    record.ms = timer.elapsed();
+    record.samples = samples * record.repeats;
+    record.bytes = bytes * record.repeats;
+    records.append(record);
+    qDebug() << "  " << name << ": " << record.ms << " ms / " << record.repeats;
+}
+
+void CBenchmark::copyBlocks(bool set, int skip)
+{
+    int x, y;
+
+    // same pattern as SRTM copy of L09-L13 build and decimation of L04-L08 build
+    if (skip>1) {
+        scratch.getHeightBlock(block, 0, 0, 129, 129, skip);
+        return;
+    }
+
+    for (y=0; y<13; y++)
+        for (x=0; x<13; x++) {
+            if (set)
+                scratch.setHeightBlock(block, x*300, y*300, 301, 301, 1); else
+                scratch.getHeightBlock(block, x*300, y*300, 301, 301, 1);
+        }
+}
+
+void CBenchmark::runCase(int testCase)
+{
+    CResampler resampler;
+    alglib::real_2d_array oldGrid, newGrid;
+    int oldSize = BENCHMARK_SPLINE_OLD_SIZE;
+    int newSize = BENCHMARK_SPLINE_NEW_SIZE;
+    int size = HGT_SOURCE_SIZE_L09_L13;
+    int x, y;
+
+    switch (testCase) {
+        case CASE_LOAD_RAW:          scratch.loadFile(rawFilename, size, size); break;
+        case CASE_SAVE_RAW:          scratch.saveFile(rawFilename); break;
+        case CASE_SAVE_ENCODED:      tile.saveFile(encodedFilename); break;
+        case CASE_LOAD_ENCODED:      scratch.loadFile(encodedFilename, size, size); break;
+        case CASE_LOAD_ENCODED_SKIP: scratch.loadFile(encodedFilename, size, size, 16); break;
+        case CASE_EXCHANGE_ENDIAN:   scratch.exchangeEndian(); break;
+        case CASE_GET_BLOCK:         copyBlocks(false, 1); break;
+        case CASE_SET_BLOCK:         copyBlocks(true, 1); break;
+        case CASE_GET_BLOCK_SKIP:    copyBlocks(false, 32); break;
+
+        case CASE_SPLINE_ALGLIB:
+            oldGrid.setlength(oldSize, oldSize);
+            newGrid.setlength(newSize, newSize);
+            for (y=0; y<oldSize; y++)
+                for (x=0; x<oldSize; x++)
+                    oldGrid[y][x] = splineSource.getHeight(x, y);
+            alglib::spline2dresamplebicubic(oldGrid, oldSize, oldSize, newGrid, newSize, newSize);
+            break;
+        case CASE_SPLINE_RESAMPLER:
+            resampler.resample(&splineSource, &splineResult);
+            break;
+
+        case CASE_BUILD_L09_L13:
+            resizer->buildL09_L13TerrainFromSRTM(BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT);
+            break;
+        case CASE_CONNECT_L09_L13:
+            resizer->connectL09_L13Terrain(BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT);
+            break;
+        case CASE_BUILD_L04_L08:
+            resizer->buildL04_L08TerrainFromL09_L13(BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT);
+            break;
+        case CASE_BUILD_L00_L03:
+            resizer->buildL00_L03TerrainFromL04_L08(BENCHMARK_TILE_LON, BENCHMARK_TILE_LAT);
+            break;
+
+        case CASE_GET_COLOR:
+            // sum keeps compiler from dropping the calls
+            for (x=0; x<65536; x++)
+                colorSum += resizer->getColor(x);
+            break;
+        case CASE_COLORIZE:
+            if (image.width()!=size)
+                image = QImage(size, size, QImage::Format_RGB32);
+            resizer->colorizeImage(&tile, &image);
+            break;
+    }
+}
+
+void CBenchmark::report(const QString &csvName)
+{
+    QFile file(csvName);
+    CBenchmarkRecord *record;
+    double nsPerSample, MBperSecond;
+    int i;
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream out(&file);
+
+        out << "name,repeats,ms,samples,ns_per_sample,MB_per_s\n";
+        qDebug() << "";
+        qDebug() << "Benchmark                              ns/sample        MB/s";
+        for (i=0; i<records.size(); i++) {
+            record = &records[i];
+            nsPerSample = (record->samples>0) ? record->ms * 1000000.0 / record->samples : 0.0;
+            MBperSecond = (record->ms>0) ? (record->bytes / 1000000.0) / (record->ms / 1000.0) : 0.0;
+
+            out << record->name << "," << record->repeats << "," << record->ms << "," << record->samples << ","
+                << QString::number(nsPerSample, 'f', 3) << "," << QString::number(MBperSecond, 'f', 1) << "\n";
+            qDebug() << qPrintable(record->name.leftJustified(36)
+                                   + QString::number(nsPerSample, 'f', 3).rightJustified(12)
+                                   + QString::number(MBperSecond, 'f', 1).rightJustified(12));
+        }
+        file.close();
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CBENCHMARK_H
+#define CBENCHMARK_H
+
+#include <QString>
+#include <QList>
+#include <QImage>
+#include "CHgtFile.h"
+
+class CResizer;
+
+#define BENCHMARK_MIN_TIME         500     // [ms] fast cases are repeated at least that long
+#define BENCHMARK_TILE_LON          15.00  // top left of benchmarked L09-L13 tile, its E
+#define BENCHMARK_TILE_LAT          52.50  // neighbour is built too for stitching
+#define BENCHMARK_SPLINE_OLD_SIZE 1126     // quarter of 4501 -> 4097 resize of L09-L13 build
+#define BENCHMARK_SPLINE_NEW_SIZE 1025
+
+class CBenchmarkRecord
+{
+public:
+    QString name;
+    int repeats;
+    int ms;
+    qint64 samples;        // all repeats
+    qint64 bytes;
+};
+
+class CBenchmark
+{
+public:
+    CBenchmark(CResizer *r);
+    ~CBenchmark();
+
+    void setup();
+    void runAll();
+    void report(const QString &csvName);
+
+private:
+    enum {
+        CASE_LOAD_RAW, CASE_SAVE_RAW, CASE_SAVE_ENCODED, CASE_LOAD_ENCODED, CASE_LOAD_ENCODED_SKIP,
+        CASE_EXCHANGE_ENDIAN, CASE_GET_BLOCK, CASE_SET_BLOCK, CASE_GET_BLOCK_SKIP,
+        CASE_SPLINE_ALGLIB, CASE_SPLINE_RESAMPLER,
+        CASE_BUILD_L09_L13, CASE_CONNECT_L09_L13, CASE_BUILD_L04_L08, CASE_BUILD_L00_L03,
+        CASE_GET_COLOR, CASE_COLORIZE
+    };
+
+    CResizer *resizer;
+    CHgtFile tile;                  // built L09-L13 tile, never modified
+    CHgtFile scratch;               // target of loads, raw saves and endian swaps
+    CHgtFile splineSource;
+    CHgtFile splineResult;
+    quint16 *block;
+    QImage image;
+    QString rawFilename;
+    QString encodedFilename;
+    QList<CBenchmarkRecord> records;
+    unsigned int colorSum;
+
+    void measure(int testCase, const QString &name, qint64 samples, qint64 bytes, int minTime);
+    void runCase(int testCase);
+    void copyBlocks(bool set, int skip);
+};
+
+#endif // CBENCHMARK_H
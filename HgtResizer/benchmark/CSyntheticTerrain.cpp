@@ -0,0 +1,169 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDebug>
+#include "CSyntheticTerrain.h"
+#include "CHgtFile.h"
+#include "CCacheManager.h"
+#include "CHgtCodec.h"
+
+CSyntheticTerrain::CSyntheticTerrain(unsigned int s)
+{
+    seed = s;
+    amplitude = 2500.0;
+    seaLevel = -500.0;
+    voidsPerMille = 100;
+}
+
+unsigned int CSyntheticTerrain::hash(qint64 x, qint64 y, unsigned int salt)
+{
+    quint64 h;
+
+    // splitmix64 finalizer of packed coordinates
+    h = ((quint64)x * 0x9E3779B97F4A7C15ULL) ^ ((quint64)y * 0xC2B2AE3D27D4EB4FULL) ^ (((quint64)(seed + salt)) << 32);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+
+    return (unsigned int)h;
+}
+
+double CSyntheticTerrain::lattice(qint64 x, qint64 y, int octave)
+{
+    return (double)hash(x, y, octave) / 4294967295.0 * 2.0 - 1.0;
+}
+
+double CSyntheticTerrain::noise(qint64 gx, qint64 gy)
+{
+    qint64 spacing, ix, iy;
+    double sum, amp, tx, ty, v00, v10, v01, v11;
+    int octave;
+
+    // octaves from 2048 samples (~1.7 deg) down to 8 samples
+    sum = 0.0;
+    amp = amplitude;
+    spacing = 2048;
+    for (octave=0; octave<SYNTHETIC_OCTAVES; octave++) {
+        ix = gx / spacing;
+        iy = gy / spacing;
+        tx = (double)(gx - ix*spacing) / spacing;
+        ty = (double)(gy - iy*spacing) / spacing;
+        tx = tx*tx*(3.0 - 2.0*tx);
+        ty = ty*ty*(3.0 - 2.0*ty);
+
+        v00 = lattice(ix, iy, octave);
+        v10 = lattice(ix + 1, iy, octave);
+        v01 = lattice(ix, iy + 1, octave);
+        v11 = lattice(ix + 1, iy + 1, octave);
+        sum += amp * ((v00*(1.0 - tx) + v10*tx)*(1.0 - ty) + (v01*(1.0 - tx) + v11*tx)*ty);
+
+        amp *= 0.5;
+        spacing /= 2;
+    }
+
+    return sum;
+}
+
+bool CSyntheticTerrain::isVoid(qint64 gx, qint64 gy)
+{
+    qint64 cx = gx / SYNTHETIC_VOID_CELL;
+    qint64 cy = gy / SYNTHETIC_VOID_CELL;
+    unsigned int h = hash(cx, cy, 1000);
+    qint64 x0, y0, r;
+
+    if ((int)(h % 1000)>=voidsPerMille) return false;
+
+    // one void per cell, inside of cell so it never crosses cell border
+    r = 3 + (h >> 10) % 28;
+    x0 = cx*SYNTHETIC_VOID_CELL + r + (h >> 15) % (SYNTHETIC_VOID_CELL - 2*r);
+    y0 = cy*SYNTHETIC_VOID_CELL + r + (h >> 22) % (SYNTHETIC_VOID_CELL - 2*r);
+
+    return ((gx - x0)*(gx - x0) + (gy - y0)*(gy - y0) < r*r);
+}
+
+int CSyntheticTerrain::getHeight(qint64 gx, qint64 gy)
+{
+    double h = noise(gx, gy) - seaLevel;
+
+    if (h<=0.0) return 0;
+    if (isVoid(gx, gy)) return SYNTHETIC_VOID_HEIGHT;
+
+    return qMin((int)(h + 0.5), 8848);
+}
+
+void CSyntheticTerrain::fillTile(CHgtFile *hgt, double tlLon, double tlLat)
+{
+    int size = hgt->getSizeX();
+    qint64 gx0, gy0;
+    int x, y;
+
+    // tile of size samples over one degree, e.g. 1201 for SRTM
+    gx0 = (qint64)(tlLon * (size - 1) + 0.5);
+    gy0 = (qint64)((90.0 - tlLat) * (size - 1) + 0.5);
+    for (y=0; y<size; y++)
+        for (x=0; x<size; x++)
+            hgt->setHeight(x, y, getHeight(gx0 + x, gy0 + y));
+}
+
+int CSyntheticTerrain::writeSRTMTiles(CCacheManager *cacheManager, double tlLon, double tlLat, int countLon, int countLat)
+{
+    int saveEncoding = CHgtFile::saveEncoding;
+    CHgtFile hgt;
+    QString filename;
+    double lon, lat;
+    int x, y;
+
+    // SRTM tiles are always raw, avability scan checks their size
+    CHgtFile::saveEncoding = HGT_ENCODING_RAW;
+    hgt.init(HGT_SOURCE_SIZE_SRTM, HGT_SOURCE_SIZE_SRTM);
+    for (y=0; y<countLat; y++)
+        for (x=0; x<countLon; x++) {
+            lon = tlLon + x*HGT_SOURCE_DEGREE_SIZE_SRTM;
+            lat = tlLat - y*HGT_SOURCE_DEGREE_SIZE_SRTM;
+            if (lon>=360.0) lon -= 360.0;
+
+            cacheManager->convertLonLatToSRTMfileName(lon, lat, &filename);
+            fillTile(&hgt, lon, lat);
+            hgt.saveFile(cacheManager->pathSRTM + filename);
+            qDebug() << "Synthetic SRTM tile " << filename;
+        }
+    CHgtFile::saveEncoding = saveEncoding;
+
+    return countLon*countLat;
+}
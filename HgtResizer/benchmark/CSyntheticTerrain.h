@@ -0,0 +1,74 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#ifndef CSYNTHETICTERRAIN_H
+#define CSYNTHETICTERRAIN_H
+
+#include <QtGlobal>
+
+class CHgtFile;
+class CCacheManager;
+
+#define SYNTHETIC_OCTAVES          9
+#define SYNTHETIC_VOID_CELL      128
+#define SYNTHETIC_VOID_HEIGHT  32768     // SRTM -32768 read as quint16
+
+// SRTM-like terrain from fractal value noise. Heights depend only on global
+// sample position (1200 samples per degree, from 0 lon / 90 lat), so edges of
+// neighbouring tiles are the same like in real SRTM. Noise below seaLevel
+// becomes sea (0 m), some land cells get round voids.
+class CSyntheticTerrain
+{
+public:
+    unsigned int seed;
+    double amplitude;           // of largest octave [m]
+    double seaLevel;            // noise level of coast [m]
+    int voidsPerMille;          // void probability of land cell
+
+    CSyntheticTerrain(unsigned int s = 1);
+    int getHeight(qint64 gx, qint64 gy);
+    void fillTile(CHgtFile *hgt, double tlLon, double tlLat);
+    int writeSRTMTiles(CCacheManager *cacheManager, double tlLon, double tlLat, int countLon, int countLat);
+
+private:
+    unsigned int hash(qint64 x, qint64 y, unsigned int salt);
+    double lattice(qint64 x, qint64 y, int octave);
+    double noise(qint64 gx, qint64 gy);
+    bool isVoid(qint64 gx, qint64 gy);
+};
+
+#endif // CSYNTHETICTERRAIN_H
@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Benchmarks of HgtResizer stages on synthetic terrain
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       += gui
+
+TARGET = HgtBenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../HgtResizer.pri)
+
+SOURCES += main.cpp \
+    CSyntheticTerrain.cpp \
+    CBenchmark.cpp
+
+HEADERS += \
+    CSyntheticTerrain.h \
+    CBenchmark.h
@@ -39,14 +39,35 @@
 #include <QtCore/QCoreApplication>
 #include <QDebug>
 #include "CResizer.h"
+#include "CTerrainProfile.h"
+#include "CTileExporter.h"
+#include "CReliefRenderer.h"
+#include "CHgtArchive.h"
+#include "CHgtFile.h"
+#include "CHgtCodec.h"
+#include "CRunReport.h"
+#include "CTrace.h"
+#include "CLog.h"
+#include "CTaskRunner.h"
 
 using namespace std;
 
 void executeTask(CResizer *resizer)
 {
     double lon = -1.0, lat = -1.0;
+    double spacing = 100.0;
+    string queriesFilename, resultsFilename;
+    CTerrainProfile profile(&resizer->cacheManager);
+    CTileExporter exporter(resizer);
+    CReliefRenderer relief(resizer);
     bool createImg = true;
-    int createImgInt, entireEarthInt;
+    bool thumbnailsOnly = false;
+    int minZoom = 0, maxZoom = 8;
+    int reliefSource = HGT_SOURCE_L04_L08;
+    int archiveSource = HGT_SOURCE_L09_L13;
+    int maxError = 0;
+    int encoding = HGT_ENCODING_RAW;
+    int createImgInt, entireEarthInt, thumbnailsOnlyInt, hillshadeInt;
     int choose;
 
     cout << "-------------------------------------------------------" << endl;
@@ -70,6 +91,11 @@ void executeTask(CResizer *resizer)
     cout << " 10. generateHtmlIndex(HGT_SOURCE_L04_L08);" << endl;
     cout << " 11. generateHtmlIndex(HGT_SOURCE_L09_L13);" << endl;
     cout << " 12. generateHtmlIndex(HGT_SOURCE_SRTM);" << endl;
+    cout << " 13. lineOfSightBatchFile(queries, results, spacing);" << endl;
+    cout << " 14. exportTiles(minZoom, maxZoom);" << endl;
+    cout << " 15. renderRelief(hgtSource, lon, lat);" << endl;
+    cout << " 16. packArchive(hgtSource);" << endl;
+    cout << " 17. unpackArchive(hgtSource);" << endl;
     cout << endl;
     cout << " Your choose: ";
     cin >> choose;
@@ -81,6 +107,17 @@ void executeTask(CResizer *resizer)
         cout << "Latitude: "; cin >> lat;
     }
 
+    if (choose>=1 && choose<=8) {
+        cout << "Tile encoding (0=raw, 2=sparse, 3=delta, 255=smaller of both): "; cin >> encoding;
+        if (encoding==HGT_ENCODING_SPARSE || encoding==HGT_ENCODING_DELTA || encoding==HGT_ENCODING_AUTO)
+            CHgtFile::saveEncoding = encoding;
+    }
+
+    if (choose>=3 && choose<=6) {
+        cout << "Max error of lossy encoding [m] (0=lossless): "; cin >> maxError;
+        resizer->lossyMaxError[(choose<=4) ? HGT_SOURCE_L04_L08 : HGT_SOURCE_L00_L03] = maxError;
+    }
+
     if (choose>=9 && choose<=12) {
         cout << "Only HTML index file (0=no, 1=yes)? "; cin >> createImgInt;
         if (createImgInt) {
@@ -90,6 +127,8 @@ void executeTask(CResizer *resizer)
         } else {
             createImg = true;
 
+            cout << "Thumbnails only (0=no, 1=yes)? "; cin >> thumbnailsOnlyInt;
+            thumbnailsOnly = (thumbnailsOnlyInt!=0);
             cout << "Images on entire earth (0=no, 1=yes)? "; cin >> entireEarthInt;
             if (entireEarthInt) {
                 lon = -1.0;
@@ -101,9 +140,36 @@ void executeTask(CResizer *resizer)
         }
     }
 
+    if (choose==13) {
+        cout << "Queries file: "; cin >> queriesFilename;
+        cout << "Results file: "; cin >> resultsFilename;
+        cout << "Spacing [m]: "; cin >> spacing;
+    }
+
+    if (choose==14) {
+        cout << "Min zoom: "; cin >> minZoom;
+        cout << "Max zoom (up to " << TILE_EXPORTER_MAX_ZOOM << "): "; cin >> maxZoom;
+        cout << "Hillshade (0=no, 1=yes)? "; cin >> hillshadeInt;
+        exporter.hillshade = (hillshadeInt!=0);
+    }
+
+    if (choose==15) {
+        cout << "Source (0=L00-L03, 1=L04-L08, 2=L09-L13, 10=SRTM): "; cin >> reliefSource;
+        cout << "Images on entire earth (0=no, 1=yes)? "; cin >> entireEarthInt;
+        if ( ! entireEarthInt) {
+            cout << "Longitude: "; cin >> lon;
+            cout << "Latitude: "; cin >> lat;
+        }
+    }
+
+    if (choose==16 || choose==17) {
+        cout << "Source (0=L00-L03, 1=L04-L08, 2=L09-L13): "; cin >> archiveSource;
+    }
+
     cout << endl;
     cout << "----------------------------------------" << endl << endl;
 
+    CRunReport::getInstance()->setTask(choose);
     switch (choose) {
         case 1:resizer->buildL09_L13TerrainFromSRTMEntireEarth(); break;
         case 2:resizer->buildL09_L13TerrainFromSRTM(lon, lat); break;
@@ -113,23 +179,58 @@ void executeTask(CResizer *resizer)
         case 6:resizer->buildL00_L03TerrainFromL04_L08(lon, lat); break;
         case 7:resizer->connectL09_L13TerrainEntireEarth(); break;
         case 8:resizer->connectL09_L13Terrain(lon, lat); break;
-        case 9:resizer->generateHtmlIndex(HGT_SOURCE_L00_L03, createImg, lon, lat); break;
-        case 10:resizer->generateHtmlIndex(HGT_SOURCE_L04_L08, createImg, lon, lat); break;
-        case 11:resizer->generateHtmlIndex(HGT_SOURCE_L09_L13, createImg, lon, lat); break;
-        case 12:resizer->generateHtmlIndex(HGT_SOURCE_SRTM, createImg, lon, lat); break;
+        case 9:resizer->generateHtmlIndex(HGT_SOURCE_L00_L03, createImg, lon, lat, thumbnailsOnly); break;
+        case 10:resizer->generateHtmlIndex(HGT_SOURCE_L04_L08, createImg, lon, lat, thumbnailsOnly); break;
+        case 11:resizer->generateHtmlIndex(HGT_SOURCE_L09_L13, createImg, lon, lat, thumbnailsOnly); break;
+        case 12:resizer->generateHtmlIndex(HGT_SOURCE_SRTM, createImg, lon, lat, thumbnailsOnly); break;
+        case 13:profile.lineOfSightBatchFile(QString::fromAscii(queriesFilename.c_str()),
+                                             QString::fromAscii(resultsFilename.c_str()), spacing); break;
+        case 14:exporter.exportTiles(minZoom, maxZoom); break;
+        case 15:relief.render(reliefSource, lon, lat); break;
+        case 16:CHgtArchive::pack(archiveSource); break;
+        case 17:CHgtArchive::unpack(archiveSource); break;
     }
 }
 
 int main(int argc, char *argv[])
 {
     int stop;
+    int status = 0;
     QCoreApplication a(argc, argv);
+
+    // timeline of threads, stages and tiles for chrome://tracing
+    if (a.arguments().contains("--trace"))
+        CTrace::enable();
+    // per sample messages (e.g. stitched border samples) or warnings only
+    if (a.arguments().contains("--debug"))
+        CLog::level = LOG_LEVEL_DEBUG;
+    if (a.arguments().contains("--quiet"))
+        CLog::level = LOG_LEVEL_WARNING;
+
     CResizer resizer;
+    CTaskRunner runner(&resizer);
+    bool batch = a.arguments().contains("--task") || a.arguments().contains("--help");
+
+    // batch jobs are configured by arguments, otherwise menu is shown
+    if (batch) {
+        if ( ! runner.parseArguments(a.arguments())) {
+            CTaskRunner::printUsage();
+            return 1;
+        }
+        if ( ! runner.run())
+            status = 1;
+    } else {
+        executeTask(&resizer);
+    }
 
-    executeTask(&resizer);
+    if ( ! CRunReport::getInstance()->saveFile(RUN_REPORT_FILENAME))
+        LOG_WARNING << "Can't write run report" << RUN_REPORT_FILENAME;
+    if (CTrace::enabled && ! CTrace::saveFile(TRACE_FILENAME))
+        LOG_WARNING << "Can't write trace" << TRACE_FILENAME;
 
-    qDebug() << ""; qDebug() << "";
-    qDebug() << "All task complete!";
-    cin >> stop;
-    return 0;
+    LOG_INFO << ""; LOG_INFO << "";
+    LOG_INFO << "All task complete!";
+    if ( ! batch)
+        cin >> stop;
+    return status;
 }
@@ -0,0 +1,116 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QSet>
+#include "CCacheManagerTest.h"
+#include "CCacheManager.h"
+#include "CTest.h"
+
+// L09_L13 grid, 96 x 48 tiles of 3.75 degree
+#define TEST_WIDTH      96
+
+void CCacheManagerTest::run()
+{
+    CCacheManager cacheManager;
+
+    testWraparound(&cacheManager);
+    testTileBorders(&cacheManager);
+    testWholeEarth(&cacheManager);
+}
+
+bool CCacheManagerTest::isUnique(const QList<int> &indexes)
+{
+    QSet<int> seen;
+    int i;
+
+    for (i=0; i<indexes.size(); i++) {
+        if (seen.contains(indexes.at(i))) return false;
+        seen.insert(indexes.at(i));
+    }
+
+    return true;
+}
+
+void CCacheManagerTest::testWraparound(CCacheManager *cacheManager)
+{
+    QList<int> indexes;
+    QList<int> same;
+
+    // -10..10 lon crosses 0/360: columns 93..95 and 0..2, rows 23 and 24
+    indexes = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, -10.0, -1.0, 10.0, 1.0);
+    CHECK(indexes.size()==12);
+    CHECK(isUnique(indexes));
+    CHECK(indexes.contains(23*TEST_WIDTH + 95));
+    CHECK(indexes.contains(23*TEST_WIDTH + 0));
+    CHECK(indexes.contains(24*TEST_WIDTH + 2));
+    CHECK( ! indexes.contains(23*TEST_WIDTH + 3));
+    CHECK( ! indexes.contains(23*TEST_WIDTH + 92));
+
+    // the same box given in 0..360 longitude
+    same = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, 350.0, -1.0, 10.0, 1.0);
+    CHECK(same==indexes);
+}
+
+void CCacheManagerTest::testTileBorders(CCacheManager *cacheManager)
+{
+    QList<int> indexes;
+
+    // tiles only touching box border are not included
+    indexes = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, 0.0, 0.0, 3.75, 3.75);
+    CHECK(indexes.size()==1);
+    CHECK(indexes.size()==1 && indexes.at(0)==23*TEST_WIDTH);
+
+    // latitude past poles is clamped, every row of one column
+    indexes = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, 5.0, -100.0, 6.0, 100.0);
+    CHECK(indexes.size()==48);
+    CHECK(isUnique(indexes));
+    CHECK(indexes.first()==1 && indexes.last()==47*TEST_WIDTH + 1);
+}
+
+void CCacheManagerTest::testWholeEarth(CCacheManager *cacheManager)
+{
+    QList<int> indexes;
+
+    // 360 degree wide box has every column once
+    indexes = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, -180.0, -1.0, 180.0, 1.0);
+    CHECK(indexes.size()==2*TEST_WIDTH);
+    CHECK(isUnique(indexes));
+
+    indexes = cacheManager->getIndexesInBox(HGT_SOURCE_DEGREE_SIZE_L09_L13, -180.0, -90.0, 180.0, 90.0);
+    CHECK(indexes.size()==TEST_WIDTH*48);
+    CHECK(isUnique(indexes));
+}
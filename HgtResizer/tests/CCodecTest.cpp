@@ -0,0 +1,195 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include "CCodecTest.h"
+#include "CTest.h"
+#include "CHgtCodec.h"
+
+#define TEST_SIZE       513
+
+void CCodecTest::run()
+{
+    testLossless(HGT_ENCODING_SPARSE);
+    testLossless(HGT_ENCODING_DELTA);
+    testLossless(HGT_ENCODING_AUTO);
+    testLossy(1);
+    testLossy(5);
+    testLossy(50);
+    testLossy(HGT_CODEC_MAX_ERROR);
+    testConstant();
+}
+
+void CCodecTest::fillTerrain(quint16 *height, int sizeX, int sizeY)
+{
+    int x, y, v;
+
+    // sea strip, noisy land, void lake, spike over 9000 and 1-3 m coast
+    srand(1);
+    for (y=0; y<sizeY; y++)
+        for (x=0; x<sizeX; x++) {
+            v = (x<200) ? 0 : 1 + (x*7 + y*13 + rand()%50) % HGT_CODEC_MAX_HEIGHT;
+            if ((x-300)*(x-300) + (y-300)*(y-300) < 400) v = HGT_CODEC_VOID;
+            if (x==400 && y<100) v = 65000;
+            if (x==210) v = 1 + rand()%3;
+            height[y*sizeX + x] = (quint16)v;
+        }
+}
+
+void CCodecTest::testLossless(int encoding)
+{
+    quint16 *height = new quint16[TEST_SIZE*TEST_SIZE];
+    quint16 *decoded = new quint16[TEST_SIZE*TEST_SIZE];
+    char *data = 0;
+    qint64 size;
+    int stored, sX, sY, i, x, y, diff;
+
+    fillTerrain(height, TEST_SIZE, TEST_SIZE);
+    size = CHgtCodec::encode(height, TEST_SIZE, TEST_SIZE, encoding, &data, 0);
+    CHECK(size>0);
+    if (size>0) {
+        CHECK(CHgtCodec::readHeader(data, size, &stored, &sX, &sY));
+        CHECK(sX==TEST_SIZE && sY==TEST_SIZE);
+        CHECK(encoding==HGT_ENCODING_AUTO || stored==encoding);
+        CHECK(CHgtCodec::verify(height, data, size, TEST_SIZE, TEST_SIZE)==0);
+
+        CHECK(CHgtCodec::decode(data, size, decoded, TEST_SIZE, TEST_SIZE));
+        diff = 0;
+        for (i=0; i<TEST_SIZE*TEST_SIZE; i++)
+            if (decoded[i]!=height[i]) diff++;
+        CHECK(diff==0);
+
+        // decimating readers need only every 8th row
+        CHECK(CHgtCodec::decode(data, size, decoded, TEST_SIZE, TEST_SIZE, 8));
+        diff = 0;
+        for (y=0; y<TEST_SIZE; y+=8)
+            for (x=0; x<TEST_SIZE; x++)
+                if (decoded[y*TEST_SIZE + x]!=height[y*TEST_SIZE + x]) diff++;
+        CHECK(diff==0);
+
+        // truncated file is rejected, not decoded into garbage
+        CHECK( ! CHgtCodec::decode(data, size/2, decoded, TEST_SIZE, TEST_SIZE));
+    }
+
+    if (data!=0) delete []data;
+    delete []height;
+    delete []decoded;
+}
+
+void CCodecTest::testLossy(int maxError)
+{
+    quint16 *height = new quint16[TEST_SIZE*TEST_SIZE];
+    quint16 *decoded = new quint16[TEST_SIZE*TEST_SIZE];
+    quint16 *again = new quint16[TEST_SIZE*TEST_SIZE];
+    char *data = 0;
+    char *data2 = 0;
+    qint64 size, size2;
+    int stored, sX, sY, i, error, bad, diff;
+
+    fillTerrain(height, TEST_SIZE, TEST_SIZE);
+    size = CHgtCodec::encode(height, TEST_SIZE, TEST_SIZE, HGT_ENCODING_LOSSY, &data, maxError);
+    CHECK(size>0);
+    if (size>0) {
+        CHECK(CHgtCodec::readHeader(data, size, &stored, &sX, &sY));
+        CHECK(stored==HGT_ENCODING_LOSSY);
+        CHECK(CHgtCodec::decode(data, size, decoded, TEST_SIZE, TEST_SIZE));
+
+        // sea and voids exact, land stays land within maxError
+        error = 0;
+        bad = 0;
+        for (i=0; i<TEST_SIZE*TEST_SIZE; i++) {
+            if (height[i]==0) {
+                if (decoded[i]!=0) bad++;
+            } else if (height[i]>HGT_CODEC_MAX_HEIGHT) {
+                if (decoded[i]!=HGT_CODEC_VOID) bad++;
+            } else {
+                if (decoded[i]<1 || decoded[i]>HGT_CODEC_MAX_HEIGHT) bad++;
+                error = qMax(error, qAbs((int)decoded[i] - (int)height[i]));
+            }
+        }
+        CHECK(bad==0);
+        CHECK(error<=maxError);
+        CHECK(CHgtCodec::verify(height, data, size, TEST_SIZE, TEST_SIZE)<=maxError);
+
+        // quantized tile saved again must not drift
+        size2 = CHgtCodec::encode(decoded, TEST_SIZE, TEST_SIZE, HGT_ENCODING_LOSSY, &data2, maxError);
+        CHECK(size2>0);
+        if (size2>0) {
+            CHECK(CHgtCodec::decode(data2, size2, again, TEST_SIZE, TEST_SIZE));
+            diff = 0;
+            for (i=0; i<TEST_SIZE*TEST_SIZE; i++)
+                if (again[i]!=decoded[i]) diff++;
+            CHECK(diff==0);
+        }
+    }
+
+    if (data!=0) delete []data;
+    if (data2!=0) delete []data2;
+    delete []height;
+    delete []decoded;
+    delete []again;
+}
+
+void CCodecTest::testConstant()
+{
+    quint16 *height = new quint16[TEST_SIZE*TEST_SIZE];
+    quint16 *decoded = new quint16[TEST_SIZE*TEST_SIZE];
+    char *data = 0;
+    qint64 size;
+    int stored, sX, sY, i, diff;
+
+    // open sea tile is a few bytes whatever encoding was asked for
+    for (i=0; i<TEST_SIZE*TEST_SIZE; i++)
+        height[i] = 0;
+    size = CHgtCodec::encode(height, TEST_SIZE, TEST_SIZE, HGT_ENCODING_DELTA, &data, 0);
+    CHECK(size>0 && size<64);
+    if (size>0) {
+        CHECK(CHgtCodec::readHeader(data, size, &stored, &sX, &sY));
+        CHECK(stored==HGT_ENCODING_CONSTANT);
+        for (i=0; i<TEST_SIZE*TEST_SIZE; i++)
+            decoded[i] = 1;
+        CHECK(CHgtCodec::decode(data, size, decoded, TEST_SIZE, TEST_SIZE));
+        diff = 0;
+        for (i=0; i<TEST_SIZE*TEST_SIZE; i++)
+            if (decoded[i]!=0) diff++;
+        CHECK(diff==0);
+    }
+
+    if (data!=0) delete []data;
+    delete []height;
+    delete []decoded;
+}
@@ -0,0 +1,113 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QFile>
+#include "CJournalTest.h"
+#include "CJournal.h"
+#include "CTest.h"
+
+void CJournalTest::run()
+{
+    QString path = CTest::tempPath("journal");
+
+    testTornLine(path);
+    testChangedOutput(path);
+}
+
+void CJournalTest::writeFile(const QString &name, const char *data, bool append)
+{
+    QFile file(name);
+
+    if ( ! file.open(append ? (QIODevice::WriteOnly | QIODevice::Append) : (QIODevice::WriteOnly | QIODevice::Truncate))) return;
+    file.write(data);
+    file.close();
+}
+
+void CJournalTest::testTornLine(const QString &path)
+{
+    CJournal journal;
+    QString name = path + "torn.txt";
+    QString output = path + "N00E000.hgt";
+
+    writeFile(output, "tile data", false);
+    CHECK(journal.open(name));
+    journal.record("build", 2, 7, output);
+    journal.close();
+
+    // crash in the middle of next record
+    writeFile(name, "build 2 8 9 00000000", true);
+
+    CHECK(journal.open(name));
+    CHECK(journal.getCount()==1);
+    CHECK(journal.isDone("build", 2, 7, output));
+    CHECK( ! journal.isDone("build", 2, 8, output));
+
+    // record after torn line must not be glued to it
+    journal.record("build", 2, 9, output);
+    journal.close();
+    CHECK(journal.open(name));
+    CHECK(journal.getCount()==2);
+    CHECK(journal.isDone("build", 2, 7, output));
+    CHECK(journal.isDone("build", 2, 9, output));
+    CHECK( ! journal.isDone("build", 2, 8, output));
+    journal.close();
+}
+
+void CJournalTest::testChangedOutput(const QString &path)
+{
+    CJournal journal;
+    QString name = path + "changed.txt";
+    QString output = path + "N00E003.hgt";
+
+    writeFile(output, "tile data", false);
+    CHECK(journal.open(name));
+    journal.record("build", 2, 1, output);
+    journal.record("connect", 2, 1, output);
+
+    // other task of the same tile is not done
+    CHECK( ! journal.isDone("sidecars", 2, 1, output));
+
+    // same size, other content: rebuilt unless stitching changed it later
+    writeFile(output, "tile DATA", false);
+    CHECK( ! journal.isDone("build", 2, 1, output, true));
+    CHECK(journal.isDone("connect", 2, 1, output, false));
+
+    // missing output is never done
+    QFile::remove(output);
+    CHECK( ! journal.isDone("connect", 2, 1, output, false));
+    journal.close();
+}
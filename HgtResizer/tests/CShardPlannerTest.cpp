@@ -0,0 +1,150 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QMap>
+#include "CShardPlannerTest.h"
+#include "CShardPlanner.h"
+#include "CTest.h"
+
+#define TEST_WIDTH      96          // L09_L13 tiles around equator
+#define TEST_SHARDS     4
+
+void CShardPlannerTest::run()
+{
+    CCacheManager cacheManager;
+    int x, y;
+
+    // land band of three rows around whole earth, denser in east
+    for (y=10; y<13; y++)
+        for (x=0; x<TEST_WIDTH; x++)
+            if (y==11 || x>=TEST_WIDTH/2)
+                cacheManager.avability_L09_L13[y*TEST_WIDTH + x].available = true;
+
+    testStitchingBands(&cacheManager);
+    testBuildBalance(&cacheManager);
+}
+
+void CShardPlannerTest::testStitchingBands(CCacheManager *cacheManager)
+{
+    CShardPlanner planner(cacheManager, TEST_SHARDS, "test");
+    QList<int> indexes;
+    QList<int> tiles;
+    QList<int> seams;
+    QMap<int, int> columnShard;
+    QMap<int, int> covered;
+    int i, s, x, previous, assigned;
+    bool ordered, sameColumn;
+
+    for (i=0; i<TEST_WIDTH*48; i++)
+        if (cacheManager->avability_L09_L13[i].available) indexes.append(i);
+    planner.assign(indexes, HGT_SOURCE_L09_L13, true);
+
+    // every tile in one shard, all tiles of column in the same one
+    assigned = 0;
+    sameColumn = true;
+    for (s=0; s<TEST_SHARDS; s++) {
+        tiles = planner.getTiles(s);
+        CHECK( ! tiles.isEmpty());
+        assigned += tiles.size();
+        for (i=0; i<tiles.size(); i++) {
+            x = tiles.at(i) % TEST_WIDTH;
+            if (columnShard.contains(x) && columnShard.value(x)!=s) sameColumn = false;
+            columnShard.insert(x, s);
+        }
+    }
+    CHECK(assigned==indexes.size());
+    CHECK(sameColumn);
+
+    // bands are contiguous from west to east
+    ordered = true;
+    previous = 0;
+    for (x=0; x<TEST_WIDTH; x++) {
+        if ( ! columnShard.contains(x)) continue;
+        if (columnShard.value(x)<previous) ordered = false;
+        previous = columnShard.value(x);
+    }
+    CHECK(ordered);
+    CHECK(columnShard.value(0)==0 && columnShard.value(TEST_WIDTH-1)==TEST_SHARDS-1);
+
+    // interior tiles and seams cover every tile once, seams only at band borders
+    for (s=0; s<TEST_SHARDS; s++) {
+        tiles = planner.getInteriorTiles(s);
+        for (i=0; i<tiles.size(); i++)
+            covered[tiles.at(i)]++;
+    }
+    seams = planner.getSeamTiles();
+    for (i=0; i<seams.size(); i++) {
+        covered[seams.at(i)]++;
+        x = seams.at(i) % TEST_WIDTH;
+        CHECK(columnShard.value((x + TEST_WIDTH - 1) % TEST_WIDTH)!=columnShard.value(x) ||
+              columnShard.value((x + 1) % TEST_WIDTH)!=columnShard.value(x));
+    }
+    CHECK(covered.size()==indexes.size());
+    for (i=0; i<indexes.size(); i++)
+        CHECK(covered.value(indexes.at(i))==1);
+    CHECK(seams.size() < indexes.size()/2);
+}
+
+void CShardPlannerTest::testBuildBalance(CCacheManager *cacheManager)
+{
+    CShardPlanner planner(cacheManager, TEST_SHARDS, "test");
+    CShardPlanner again(cacheManager, TEST_SHARDS, "test");
+    QList<int> indexes;
+    qint64 minLoad, maxLoad;
+    int i, s, assigned;
+
+    // L04_L08 tiles weighted by available L09_L13 tiles under them
+    for (i=0; i<24*12; i++)
+        indexes.append(i);
+    planner.assign(indexes, HGT_SOURCE_L04_L08, false);
+    again.assign(indexes, HGT_SOURCE_L04_L08, false);
+
+    // longest processing time first: loads differ by at most one tile (16 inputs)
+    assigned = 0;
+    minLoad = planner.getLoad(0);
+    maxLoad = planner.getLoad(0);
+    for (s=0; s<TEST_SHARDS; s++) {
+        assigned += planner.getTiles(s).size();
+        minLoad = qMin(minLoad, planner.getLoad(s));
+        maxLoad = qMax(maxLoad, planner.getLoad(s));
+        // every process computes the same plan
+        CHECK(planner.getTiles(s)==again.getTiles(s));
+    }
+    CHECK(assigned==planner.getTilesByWeight().size());
+    CHECK(assigned>0);
+    CHECK(maxLoad - minLoad <= 16);
+}
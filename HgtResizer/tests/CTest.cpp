@@ -0,0 +1,79 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include "CTest.h"
+
+using namespace std;
+
+int CTest::checks = 0;
+int CTest::failures = 0;
+
+void CTest::check(bool ok, const char *expr, const char *file, int line)
+{
+    checks++;
+    if (ok) return;
+
+    failures++;
+    cout << file << ":" << line << ": CHECK(" << expr << ") failed" << endl;
+}
+
+QString CTest::tempPath(const QString &name)
+{
+    QString path = QDir::tempPath() + "/HgtResizer_tests/" + name + "/";
+    QDir dir(path);
+    QStringList files;
+    QStringList dirs;
+    int i, j;
+
+    // files and lock directories of previous run would change results
+    QDir().mkpath(path);
+    dirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (i=0; i<dirs.size(); i++) {
+        files = QDir(path + dirs.at(i)).entryList(QDir::Files);
+        for (j=0; j<files.size(); j++)
+            QFile::remove(path + dirs.at(i) + "/" + files.at(j));
+        dir.rmdir(dirs.at(i));
+    }
+    files = dir.entryList(QDir::Files);
+    for (i=0; i<files.size(); i++)
+        dir.remove(files.at(i));
+
+    return path;
+}
@@ -0,0 +1,128 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <QDir>
+#include "CWorkQueueTest.h"
+#include "CWorkQueue.h"
+#include "CTest.h"
+
+#define TEST_LEASE      1           // [s]
+#define TEST_WAIT       2500        // [ms] longer than lease, shorter than heartbeat period
+
+void CWorkQueueTest::run()
+{
+    CCacheManager cacheManager;
+
+    testClaim(&cacheManager, CTest::tempPath("queue_claim"));
+    testSteal(&cacheManager, CTest::tempPath("queue_steal"));
+    testHeartbeat(&cacheManager, CTest::tempPath("queue_heartbeat"));
+}
+
+void CWorkQueueTest::testClaim(CCacheManager *cacheManager, const QString &path)
+{
+    CWorkQueue first(cacheManager, path, "claim", "build", 2);
+    CWorkQueue second(cacheManager, path, "claim", "build", 2);
+    CWorkQueue other(cacheManager, path, "other", "build", 2);
+    QList<int> jobs;
+    bool allDone;
+
+    jobs << 1 << 2;
+
+    // job is claimed once, second worker gets the next one
+    CHECK(first.claim(jobs, false, &allDone)==1);
+    CHECK(second.claim(jobs, false, &allDone)==2);
+    CHECK(first.claim(jobs, false, &allDone)==-1 && ! allDone);
+
+    first.complete(1);
+    second.fail(2);
+    CHECK(second.claim(jobs, false, &allDone)==-1 && allDone);
+
+    // failed job is retried by other worker
+    CHECK(first.claim(jobs, false, &allDone)==2);
+    first.complete(2);
+    CHECK(first.claim(jobs, false, &allDone)==-1 && allDone);
+
+    // done files of one run are not taken for other run
+    CHECK(other.claim(jobs, false, &allDone)==1);
+    other.release();
+}
+
+void CWorkQueueTest::testSteal(CCacheManager *cacheManager, const QString &path)
+{
+    CWorkQueue dead(cacheManager, path, "steal", "build", 2);
+    CWorkQueue alive(cacheManager, path, "steal", "build", 2);
+    QList<int> jobs;
+    bool allDone;
+
+    jobs << 7;
+    alive.setLease(TEST_LEASE);
+
+    // holder stops beating, lease is measured from first observation
+    CHECK(dead.claim(jobs, false, &allDone)==7);
+    CHECK(alive.claim(jobs, false, &allDone)==-1);
+    CWorkQueue::sleep(TEST_WAIT);
+    CHECK(alive.claim(jobs, false, &allDone)==7);
+
+    // old holder must not remove lock of worker that took job over
+    dead.release();
+    CHECK(QDir().exists(path + "steal_build_2_7.lock"));
+
+    alive.complete(7);
+    CHECK( ! QDir().exists(path + "steal_build_2_7.lock"));
+    CHECK(dead.claim(jobs, false, &allDone)==-1 && allDone);
+}
+
+void CWorkQueueTest::testHeartbeat(CCacheManager *cacheManager, const QString &path)
+{
+    CWorkQueue holder(cacheManager, path, "beat", "build", 2);
+    CWorkQueue other(cacheManager, path, "beat", "build", 2);
+    QList<int> jobs;
+    bool allDone;
+
+    jobs << 3;
+    other.setLease(TEST_LEASE);
+
+    // changing heartbeat keeps lease whatever time has passed
+    CHECK(holder.claim(jobs, false, &allDone)==3);
+    CHECK(other.claim(jobs, false, &allDone)==-1);
+    CWorkQueue::sleep(TEST_WAIT);
+    holder.touchAll();
+    CHECK(other.claim(jobs, false, &allDone)==-1);
+
+    holder.complete(3);
+    CHECK(other.claim(jobs, false, &allDone)==-1 && allDone);
+}
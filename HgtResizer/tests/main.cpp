@@ -0,0 +1,63 @@
+/*
+ *   -------------------------------------------------------------------------
+ *    HgtResizer v1.0
+ *                                                    (c) Robert Rypula 156520
+ *                                   Wroclaw University of Technology - Poland
+ *                                                      http://www.pwr.wroc.pl
+ *                                                           2011.01 - 2011.06
+ *   -------------------------------------------------------------------------
+ *
+ *   What is this:
+ *     - SRTM data resizer from 92.77m to 101.92m grid for more flexible LOD
+ *       division in HgtReader program
+ *     - html HGT index generator with jpg terrain presentation
+ *     - part of my thesis "Rendering of complex 3D scenes"
+ *
+ *   What it use:
+ *     - Nokia Qt cross-platform C++ application framework
+ *     - NASA SRTM terrain elevation data:
+ *         oryginal dataset
+ *           http://dds.cr.usgs.gov/srtm/version2_1/SRTM3/
+ *         corrected part of earth:
+ *           http://www.viewfinderpanoramas.org/dem3.html
+ *         SRTM v4 highest quality SRTM dataset avaiable:
+ *           http://srtm.csi.cgiar.org/
+ *     - ALGLIB cross-platform numerical analysis and data processing library
+ *         ALGLIB website:
+ *           http://www.alglib.net/
+ *
+ *   Contact to author:
+ *            phone    +48 505-363-331
+ *            e-mail   robert.rypula@gmail.com
+ *            GG       1578139
+ *
+ *                                                   program under GNU licence
+ *   -------------------------------------------------------------------------
+ */
+
+#include <iostream>
+#include <QtCore/QCoreApplication>
+#include "CTest.h"
+#include "CCodecTest.h"
+#include "CCacheManagerTest.h"
+#include "CJournalTest.h"
+#include "CShardPlannerTest.h"
+#include "CWorkQueueTest.h"
+
+using namespace std;
+
+// Runs all unit tests, exit code is number of failed checks
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    CCodecTest::run();
+    CCacheManagerTest::run();
+    CJournalTest::run();
+    CShardPlannerTest::run();
+    CWorkQueueTest::run();
+
+    cout << CTest::getChecks() << " checks, " << CTest::getFailures() << " failed" << endl;
+
+    return CTest::getFailures();
+}
@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# Unit tests of HgtResizer classes, exit code is number of failed checks
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       += gui
+
+TARGET = HgtTests
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../HgtResizer.pri)
+
+SOURCES += main.cpp \
+    CTest.cpp \
+    CCodecTest.cpp \
+    CCacheManagerTest.cpp \
+    CJournalTest.cpp \
+    CShardPlannerTest.cpp \
+    CWorkQueueTest.cpp
+
+HEADERS += \
+    CTest.h \
+    CCodecTest.h \
+    CCacheManagerTest.h \
+    CJournalTest.h \
+    CShardPlannerTest.h \
+    CWorkQueueTest.h